@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "gd_epaper.h"
 
 #ifdef GD_EPAPER_USE_SOFTWARE_SPI
@@ -92,24 +94,531 @@ static void write_data(gd_epaper_display_dev *display, uint8_t value)
 #endif
     spi_write(display, value, false);
 }
+/*!
+ * @brief internal data block write function, on hardware 4-wire SPI sends block in as few transactions as possible
+ */
+static void write_data_buffer(gd_epaper_display_dev *display, const uint8_t *data, size_t len)
+{
+#if defined(GD_EPAPER_USE_HARDWARE_SPI) && defined(GD_EPAPER_USE_4_WIRE_SPI)
+    size_t chunk;
+    display->gpio_write_fptr(display->dc_pin, GD_EPAPER_GPIO_HIGH); // data write
+    while (len > 0)
+    {
+        chunk = (len < GD_EPAPER_SPI_CHUNK_SIZE) ? len : GD_EPAPER_SPI_CHUNK_SIZE;
+        display->spi_write_fptr((uint8_t *)data, chunk * 8);
+        data += chunk;
+        len -= chunk;
+    }
+#else
+    // every byte needs own D/C bit or bit banging, send one by one
+    for (size_t i = 0; i < len; i++)
+    {
+        write_data(display, data[i]);
+    }
+#endif
+}
+#if defined(GD_EPAPER_USE_HARDWARE_SPI) && defined(GD_EPAPER_USE_4_WIRE_SPI)
+/*!
+ * @brief Internal function to get constant pattern block of color. Blocks are shared by all displays and kept in RAM
+ * for DMA, they are never changed after first fill, so circular DMA may read them after repeat write returns
+ */
+static uint8_t *pattern_block(gd_epaper_color color)
+{
+    static uint8_t white[GD_EPAPER_PATTERN_BLOCK_SIZE]; // zero initialized
+    static uint8_t black[GD_EPAPER_PATTERN_BLOCK_SIZE];
+
+    if (color == GD_EPAPER_WHITE)
+    {
+        return white;
+    }
+    if (black[GD_EPAPER_PATTERN_BLOCK_SIZE - 1] != GD_EPAPER_BLACK)
+    {
+        // filled once on first use, repeated fill writes same values only
+        memset(black, GD_EPAPER_BLACK, sizeof(black));
+    }
+    return black;
+}
+#endif
+/*!
+ * @brief internal constant data write function, streams count bytes of same color from small block
+ */
+static void write_data_pattern(gd_epaper_display_dev *display, gd_epaper_color color, size_t count)
+{
+#if defined(GD_EPAPER_USE_HARDWARE_SPI) && defined(GD_EPAPER_USE_4_WIRE_SPI)
+    uint8_t *block = pattern_block(color);
+    size_t blocks = count / GD_EPAPER_PATTERN_BLOCK_SIZE;
+
+    if (display->spi_write_repeat_fptr != NULL && blocks > 0)
+    {
+        // platform repeats block itself, e.g. circular DMA
+        display->gpio_write_fptr(display->dc_pin, GD_EPAPER_GPIO_HIGH); // data write
+        display->spi_write_repeat_fptr(block, GD_EPAPER_PATTERN_BLOCK_SIZE * 8, blocks);
+        count -= blocks * GD_EPAPER_PATTERN_BLOCK_SIZE;
+    }
+    while (count > 0)
+    {
+        blocks = (count < GD_EPAPER_PATTERN_BLOCK_SIZE) ? count : GD_EPAPER_PATTERN_BLOCK_SIZE;
+        write_data_buffer(display, block, blocks);
+        count -= blocks;
+    }
+#else
+    for (; count > 0; count--)
+    {
+        write_data(display, (uint8_t)color);
+    }
+#endif
+}
+
+/*!
+ * @brief Decompressed data consumer
+ */
+typedef void (*rle_sink_fptr_t)(void *ctx, const uint8_t *data, size_t len);
+
+/*!
+ * @brief Internal function to decompress frame in small chunks. Exactly out_size bytes always goes to sink,
+ * corrupted stream is truncated or padded with zeros
+ *
+ * @param[in] src              : Compressed frame
+ * @param[in] size             : Compressed frame size
+ * @param[in] out_size         : Expected decompressed size
+ * @param[in] sink             : Chunk consumer
+ * @param[in] ctx              : Chunk consumer context
+ *
+ * @retval GD_EPAPER_OK              -> Success.
+ * @retval GD_EPAPER_E_CORRUPTED     -> Stream is truncated or doesn't match out_size.
+ */
+static int8_t rle_decode(const uint8_t *src, size_t size, size_t out_size, rle_sink_fptr_t sink, void *ctx)
+{
+    uint8_t chunk[GD_EPAPER_STREAM_CHUNK_SIZE];
+    size_t fill = 0;
+    size_t pos = 0;
+    size_t len;
+    size_t part;
+    bool run;
+    int8_t rslt = GD_EPAPER_OK;
+
+    while (out_size > 0)
+    {
+        if (pos >= size)
+        {
+            // stream ended early, pad with zeros
+            rslt = GD_EPAPER_E_CORRUPTED;
+            run = true;
+            len = out_size;
+        }
+        else
+        {
+            run = (src[pos] & 0x80) != 0;
+            len = run ? (size_t)(src[pos] & 0x7F) + GD_EPAPER_RLE_RUN_MIN : (size_t)src[pos] + 1;
+            pos++;
+            if (pos + (run ? 1 : len) > size)
+            {
+                rslt = GD_EPAPER_E_CORRUPTED;
+                pos = size;
+                continue;
+            }
+            if (len > out_size)
+            {
+                rslt = GD_EPAPER_E_CORRUPTED;
+                len = out_size;
+            }
+        }
+        out_size -= len;
+        while (len > 0)
+        {
+            part = sizeof(chunk) - fill;
+            part = (len < part) ? len : part;
+            if (!run)
+            {
+                memcpy(&chunk[fill], &src[pos], part);
+                pos += part;
+            }
+            else
+            {
+                memset(&chunk[fill], (pos < size) ? src[pos] : 0x00, part);
+            }
+            fill += part;
+            len -= part;
+            if (fill == sizeof(chunk))
+            {
+                sink(ctx, chunk, fill);
+                fill = 0;
+            }
+        }
+        if (run && pos < size)
+        {
+            pos++; // skip run value
+        }
+    }
+    if (fill > 0)
+    {
+        sink(ctx, chunk, fill);
+    }
+    if (pos != size)
+    {
+        rslt = GD_EPAPER_E_CORRUPTED; // trailing data
+    }
+    return rslt;
+}
+/*!
+ * @brief Decompressed data consumer, which sends chunk to display
+ */
+static void rle_sink_display(void *ctx, const uint8_t *data, size_t len)
+{
+    write_data_buffer((gd_epaper_display_dev *)ctx, data, len);
+}
+/*!
+ * @brief Decompressed data consumer, which appends chunk to memory buffer
+ */
+static void rle_sink_memory(void *ctx, const uint8_t *data, size_t len)
+{
+    uint8_t **out = (uint8_t **)ctx;
+    memcpy(*out, data, len);
+    *out += len;
+}
+/*!
+ * @brief Decompressed data consumer, which drops chunk, used to validate stream
+ */
+static void rle_sink_none(void *ctx, const uint8_t *data, size_t len)
+{
+    (void)ctx;
+    (void)data;
+    (void)len;
+}
 
 /*!
- * @brief Internal function to wait display refresh. Loop until ic set 0 on busy pin
+ * @brief Internal function to wait display refresh. Sleeps through most of learned operation duration
+ * in single delay, then loop until ic set 0 on busy pin
  *
  * @param[in] display          : Display device pointer
+ * @param[in] op               : Operation to wait, selects duration estimate
  */
-static void wait_display(gd_epaper_display_dev *display)
+static void wait_display(gd_epaper_display_dev *display, gd_epaper_busy_op op)
 {
+    uint32_t estimate = display->busy_estimate_us[op];
+    uint32_t poll = gd_epaper_busy_poll_us(estimate);
+    uint32_t elapsed = gd_epaper_busy_sleep_us(estimate);
+    uint32_t edge_wait = 0;
+    uint32_t polls = 0;
     uint8_t busy;
-    do
+
+    if (elapsed > 0)
+    {
+        // sleep until short before expected completion
+        display->delay_us_fptr(elapsed);
+    }
+    if (display->wait_busy_fptr != NULL)
+    {
+        // platform waits for BUSY edge, polling below only confirms it
+        edge_wait = display->wait_busy_fptr(display->busy_pin, GD_EPAPER_BUSY_TIMEOUT_US);
+        elapsed += edge_wait;
+    }
+    for (;;)
     {
         write_command(display, GD_EPAPER_DISPLAY_WAIT);
         busy = (uint8_t)(display->gpio_read_fptr(display->busy_pin));
         busy = !(busy & 0x01);
-        display->delay_us_fptr(100);
-    } while (busy);
+        if (!busy)
+        {
+            break;
+        }
+        display->delay_us_fptr(poll);
+        elapsed += poll;
+        polls++;
+    }
     display->delay_us_fptr(200); // minimum 100 us
+
+    display->busy_estimate_us[op] = gd_epaper_busy_estimate_us(estimate, elapsed, edge_wait, polls);
+}
+/*!
+ * @brief Internal function to check screen buffer is transposed relative to controller RAM (90/270 rotation)
+ */
+static inline bool is_transposed(const gd_epaper_display_dev *display)
+{
+    return display->rotation == GD_EPAPER_ROTATE_90 || display->rotation == GD_EPAPER_ROTATE_270;
 }
+/*!
+ * @brief Internal function to calculate panel setting with scan direction bits for display orientation.
+ * Transposed data + source mirroring gives 90, + gate mirroring gives 270, both mirrorings give 180
+ */
+static uint8_t panel_setting(const gd_epaper_display_dev *display)
+{
+    uint8_t mirror = display->mirror & (GD_EPAPER_MIRROR_X | GD_EPAPER_MIRROR_Y);
+    uint8_t value = GD_EPAPER_PANNEL_SETTING_2;
+
+    if (is_transposed(display))
+    {
+        // screen buffer X axis is controller Y axis
+        mirror = (uint8_t)(((mirror & GD_EPAPER_MIRROR_X) << 1) | ((mirror & GD_EPAPER_MIRROR_Y) >> 1));
+    }
+    switch (display->rotation)
+    {
+    case GD_EPAPER_ROTATE_90:
+        mirror ^= GD_EPAPER_MIRROR_X;
+        break;
+    case GD_EPAPER_ROTATE_180:
+        mirror ^= GD_EPAPER_MIRROR_X | GD_EPAPER_MIRROR_Y;
+        break;
+    case GD_EPAPER_ROTATE_270:
+        mirror ^= GD_EPAPER_MIRROR_Y;
+        break;
+    default:
+        break;
+    }
+    if (mirror & GD_EPAPER_MIRROR_X)
+    {
+        value ^= GD_EPAPER_PANNEL_SHL;
+    }
+    if (mirror & GD_EPAPER_MIRROR_Y)
+    {
+        value ^= GD_EPAPER_PANNEL_UD;
+    }
+    return value;
+}
+/*!
+ * @brief Internal function to convert screen buffer region to controller RAM region
+ */
+static gd_epaper_region region_to_ram(const gd_epaper_display_dev *display, const gd_epaper_region *region)
+{
+    gd_epaper_region ram = *region;
+
+    if (is_transposed(display))
+    {
+        ram.x = region->y;
+        ram.y = region->x;
+        ram.width = region->height;
+        ram.height = region->width;
+    }
+    return ram;
+}
+/*!
+ * @brief Internal function to transpose 8x8 bit matrix, rows are MSB first bytes (Hacker's Delight, 7-3)
+ *
+ * @param[in] in               : Source rows, in[k] bit (7 - j) is pixel (j, k)
+ * @param[in] stride           : Distance between source rows in bytes
+ * @param[out] out             : Transposed rows, out[j] bit (7 - k) is pixel (j, k)
+ * @param[in] out_stride       : Distance between transposed rows in bytes
+ */
+static void transpose8(const uint8_t *in, size_t stride, uint8_t *out, size_t out_stride)
+{
+    uint64_t x = 0;
+    uint64_t t;
+
+    for (uint8_t k = 0; k < 8; k++)
+    {
+        x = (x << 8) | in[k * stride];
+    }
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    for (int8_t j = 7; j >= 0; j--)
+    {
+        out[j * out_stride] = (uint8_t)x;
+        x >>= 8;
+    }
+}
+/*!
+ * @brief Internal function to send controller RAM region from screen buffer sized frame.
+ * Transposed frames are converted in 8 rows bands, so no second frame buffer needed
+ *
+ * @param[in] display          : Display device pointer
+ * @param[in] frame            : Screen buffer sized frame
+ * @param[in] ram              : Controller RAM region, x and width must be multiple of 8
+ */
+static void send_plane(gd_epaper_display_dev *display, const uint8_t *frame, const gd_epaper_region *ram)
+{
+    const size_t stride = GD_EPAPER_WIDTH / 8;
+    const size_t src_stride = GD_EPAPER_HEIGHT / 8; // transposed frame row size
+    size_t col = ram->x / 8;
+    size_t cols = ram->width / 8;
+    size_t row = ram->y;
+    size_t row_end = (size_t)ram->y + ram->height;
+    uint8_t band[8 * (GD_EPAPER_WIDTH / 8)];
+    size_t band_row;
+    size_t first;
+    size_t last;
+
+    if (!is_transposed(display))
+    {
+        if (cols == stride)
+        {
+            // whole rows are contiguous
+            write_data_buffer(display, &frame[row * stride], (row_end - row) * stride);
+            return;
+        }
+        for (; row < row_end; row++)
+        {
+            write_data_buffer(display, &frame[row * stride + col], cols);
+        }
+        return;
+    }
+    // controller rows 8 * band_row ... 8 * band_row + 7 are screen buffer byte column band_row
+    for (band_row = row / 8; band_row * 8 < row_end; band_row++)
+    {
+        for (size_t c = 0; c < cols; c++)
+        {
+            transpose8(&frame[(col + c) * 8 * src_stride + band_row], src_stride, &band[c], cols);
+        }
+        first = (band_row * 8 < row) ? row - band_row * 8 : 0;
+        last = (band_row * 8 + 8 > row_end) ? row_end - band_row * 8 : 8;
+        write_data_buffer(display, &band[first * cols], (last - first) * cols);
+    }
+}
+/*!
+ * @brief Internal function to send old data plane. Partial mode skips it, as controller keeps
+ * displayed frame there (N2OCP)
+ */
+static void send_old_data(gd_epaper_display_dev *display, size_t count)
+{
+    if (display->refresh_mode == GD_EPAPER_REFRESH_PARTIAL)
+    {
+        return;
+    }
+    write_command(display, GD_EPAPER_DATA_OLD); // Transfer old data
+    write_data_pattern(display, GD_EPAPER_WHITE, count); // zero send required here
+}
+/*!
+ * @brief Internal function to finish update: deep sleep after full refresh,
+ * power off only after fast/partial, so RAM is retained for next partial refresh
+ */
+static void send_finish(gd_epaper_display_dev *display)
+{
+    if (display->refresh_mode == GD_EPAPER_REFRESH_FULL)
+    {
+        gd_epaper_send_sleep(display);
+    }
+    else
+    {
+        gd_epaper_send_power_off(display);
+    }
+}
+/*!
+ * @brief Internal function to check controller RAM region is inside screen and horizontally byte aligned
+ */
+static bool region_valid(const gd_epaper_region *region)
+{
+    return region->width > 0 && region->height > 0 &&
+           (region->x % 8) == 0 && (region->width % 8) == 0 &&
+           (uint32_t)region->x + region->width <= GD_EPAPER_WIDTH &&
+           (uint32_t)region->y + region->height <= GD_EPAPER_HEIGHT;
+}
+/*!
+ * @brief Internal function to clip controller RAM region to screen and extend it to byte aligned horizontal bounds
+ *
+ * @retval true if region is not empty
+ */
+static bool region_align(gd_epaper_region *ram)
+{
+    uint32_t x_end = (uint32_t)ram->x + ram->width;
+    uint32_t y_end = (uint32_t)ram->y + ram->height;
+
+    x_end = (x_end > GD_EPAPER_WIDTH) ? GD_EPAPER_WIDTH : (x_end + 7) & ~7UL;
+    y_end = (y_end > GD_EPAPER_HEIGHT) ? GD_EPAPER_HEIGHT : y_end;
+    ram->x &= ~7U;
+    if (ram->x >= x_end || ram->y >= y_end)
+    {
+        return false;
+    }
+    ram->width = (uint16_t)(x_end - ram->x);
+    ram->height = (uint16_t)(y_end - ram->y);
+    return true;
+}
+/*!
+ * @brief Internal function to enter partial mode and set partial window
+ *
+ * @param[in] display          : Display device pointer
+ * @param[in] region           : Valid, byte aligned controller RAM region
+ */
+static void send_partial_in(gd_epaper_display_dev *display, const gd_epaper_region *region)
+{
+    uint16_t x_end = region->x + region->width - 1;
+    uint16_t y_end = region->y + region->height - 1;
+
+    write_command(display, GD_EPAPER_PARTIAL_IN);
+    write_command(display, GD_EPAPER_PARTIAL_WINDOW);
+    write_data(display, (uint8_t)(region->x >> 8)); // horizontal start, low 3 bits ignored
+    write_data(display, (uint8_t)(region->x & 0xF8));
+    write_data(display, (uint8_t)(x_end >> 8)); // horizontal end, low 3 bits must be 1
+    write_data(display, (uint8_t)(x_end | 0x07));
+    write_data(display, (uint8_t)(region->y >> 8)); // vertical start
+    write_data(display, (uint8_t)(region->y & 0xFF));
+    write_data(display, (uint8_t)(y_end >> 8)); // vertical end
+    write_data(display, (uint8_t)(y_end & 0xFF));
+    write_data(display, GD_EPAPER_PARTIAL_SCAN);
+}
+size_t gd_epaper_compress_frame(const uint8_t *frame, size_t frame_size, uint8_t *out, size_t out_size)
+{
+    size_t pos = 0;
+    size_t written = 0;
+    size_t literal;
+    size_t run;
+
+    if (frame == NULL || out == NULL)
+    {
+        return 0;
+    }
+    while (pos < frame_size)
+    {
+        // repeated bytes from current position
+        for (run = 1; pos + run < frame_size && run < GD_EPAPER_RLE_RUN_MAX && frame[pos + run] == frame[pos]; run++)
+            ;
+        if (run >= GD_EPAPER_RLE_RUN_MIN)
+        {
+            if (written + 2 > out_size)
+            {
+                return 0;
+            }
+            out[written++] = (uint8_t)(0x80 | (run - GD_EPAPER_RLE_RUN_MIN));
+            out[written++] = frame[pos];
+            pos += run;
+            continue;
+        }
+        // literal bytes until next run worth encoding
+        for (literal = 1; pos + literal < frame_size && literal < GD_EPAPER_RLE_LITERAL_MAX; literal++)
+        {
+            if (pos + literal + 2 < frame_size &&
+                frame[pos + literal] == frame[pos + literal + 1] &&
+                frame[pos + literal] == frame[pos + literal + 2])
+            {
+                break;
+            }
+        }
+        if (written + 1 + literal > out_size)
+        {
+            return 0;
+        }
+        out[written++] = (uint8_t)(literal - 1);
+        memcpy(&out[written], &frame[pos], literal);
+        written += literal;
+        pos += literal;
+    }
+    return written;
+}
+
+int8_t gd_epaper_decompress_frame(const uint8_t *data, size_t size, uint8_t *frame, size_t frame_size)
+{
+    uint8_t *out = frame;
+
+    if (data == NULL || frame == NULL)
+    {
+        return GD_EPAPER_E_NULL_PTR;
+    }
+    return rle_decode(data, size, frame_size, rle_sink_memory, &out);
+}
+
+uint16_t gd_epaper_get_width(const gd_epaper_display_dev *display)
+{
+    return is_transposed(display) ? GD_EPAPER_HEIGHT : GD_EPAPER_WIDTH;
+}
+
+uint16_t gd_epaper_get_height(const gd_epaper_display_dev *display)
+{
+    return is_transposed(display) ? GD_EPAPER_WIDTH : GD_EPAPER_HEIGHT;
+}
+
 #ifdef GDEY075T7
 
 void gd_epaper_send_init(gd_epaper_display_dev *display)
@@ -127,10 +636,10 @@ void gd_epaper_send_init(gd_epaper_display_dev *display)
     write_data(display, GD_EPAPER_VDL);     // VDL=-15V
 
     write_command(display, GD_EPAPER_POWER_ON); // Power on
-    wait_display(display);                      // waiting for the electronic paper IC to release the idle signal
+    wait_display(display, GD_EPAPER_BUSY_POWER_ON); // waiting for the electronic paper IC to release the idle signal
 
     write_command(display, GD_EPAPER_PANNEL_SETTING_1); // PANNEL SETTING
-    write_data(display, GD_EPAPER_PANNEL_SETTING_2);    // KW-3f   KWR-2F BWROTP 0f BWOTP 1f
+    write_data(display, panel_setting(display));        // KW-3f   KWR-2F BWROTP 0f BWOTP 1f, scan directions
 
     write_command(display, GD_EPAPER_PANNEL_SETTING_3); // tres
     write_data(display, GD_EPAPER_HRES_BYTE_HIGH);      // source 800
@@ -142,18 +651,44 @@ void gd_epaper_send_init(gd_epaper_display_dev *display)
     write_data(display, GD_EPAPER_PANNEL_SETTING_5);
 
     write_command(display, GD_EPAPER_VCOM_1); // VCOM AND DATA INTERVAL SETTING
-    write_data(display, GD_EPAPER_VCOM_2);
+    if (display->refresh_mode == GD_EPAPER_REFRESH_FULL)
+    {
+        write_data(display, GD_EPAPER_VCOM_2);
+    }
+    else
+    {
+        write_data(display, GD_EPAPER_VCOM_2 | GD_EPAPER_VCOM_N2OCP); // keep displayed frame for partial refresh
+    }
     write_data(display, GD_EPAPER_VCOM_3);
 
     write_command(display, GD_EPAPER_TCON_1); // TCON SETTING
     write_data(display, GD_EPAPER_TCON_2);
+
+    if (display->refresh_mode != GD_EPAPER_REFRESH_FULL)
+    {
+        write_command(display, GD_EPAPER_CASCADE); // fixed temperature
+        write_data(display, GD_EPAPER_CASCADE_TSFIX);
+        write_command(display, GD_EPAPER_FORCE_TEMP); // temperature selecting faster waveform
+        write_data(display, (display->refresh_mode == GD_EPAPER_REFRESH_FAST) ? GD_EPAPER_FORCE_TEMP_FAST : GD_EPAPER_FORCE_TEMP_PARTIAL);
+    }
 }
 
 void gd_epaper_send_refresh(gd_epaper_display_dev *display)
 {
     write_command(display, GD_EPAPER_DISPLAY_REFRESH); // send refresh
     display->delay_us_fptr(20);                        //!!! The delay here is necessary, 20uS at least!!!
-    wait_display(display);                             //  wait until drawing
+    switch (display->refresh_mode)                     //  wait until drawing
+    {
+    case GD_EPAPER_REFRESH_FAST:
+        wait_display(display, GD_EPAPER_BUSY_REFRESH_FAST);
+        break;
+    case GD_EPAPER_REFRESH_PARTIAL:
+        wait_display(display, GD_EPAPER_BUSY_REFRESH_PARTIAL);
+        break;
+    default:
+        wait_display(display, GD_EPAPER_BUSY_REFRESH);
+        break;
+    }
 }
 
 void gd_epaper_send_sleep(gd_epaper_display_dev *display)
@@ -161,35 +696,161 @@ void gd_epaper_send_sleep(gd_epaper_display_dev *display)
     write_command(display, 0x50);
     write_data(display, 0xF7);
 
-    write_command(display, 0x02); // power off
-    wait_display(display);        // wait until execute
-    write_command(display, 0x07); // deep sleep
-    write_data(display, 0xA5);
+    gd_epaper_send_power_off(display);
+    write_command(display, GD_EPAPER_DEEP_SLEEP); // deep sleep
+    write_data(display, GD_EPAPER_DEEP_SLEEP_CHECK);
+}
+
+void gd_epaper_send_power_off(gd_epaper_display_dev *display)
+{
+    write_command(display, GD_EPAPER_POWER_OFF);     // power off
+    wait_display(display, GD_EPAPER_BUSY_POWER_OFF); // wait until execute
 }
 
 void gd_epaper_send_buffer(gd_epaper_display_dev *display)
 {
-    size_t i;
-    write_command(display, 0x10); // Transfer old data
-    for (i = 0; i < GD_EPAPER_SCREEN_BUFFER_SIZE; i++)
+    gd_epaper_send_frame(display, display->screen_buffer);
+}
+
+void gd_epaper_send_frame(gd_epaper_display_dev *display, const uint8_t *frame)
+{
+    const gd_epaper_region ram = {0, 0, GD_EPAPER_WIDTH, GD_EPAPER_HEIGHT};
+
+    send_old_data(display, GD_EPAPER_SCREEN_BUFFER_SIZE);
+
+    write_command(display, GD_EPAPER_DATA_NEW); // Transfer new data
+    send_plane(display, frame, &ram);
+    wait_display(display, GD_EPAPER_BUSY_TRANSFER); // wait until execute
+}
+
+void gd_epaper_update_screen(gd_epaper_display_dev *display)
+{
+    gd_epaper_send_init(display);
+    gd_epaper_send_buffer(display);
+
+    gd_epaper_send_refresh(display);
+    send_finish(display);
+}
+
+void gd_epaper_send_fill(gd_epaper_display_dev *display, gd_epaper_color color)
+{
+    send_old_data(display, GD_EPAPER_SCREEN_BUFFER_SIZE);
+
+    write_command(display, GD_EPAPER_DATA_NEW); // Transfer new data
+    write_data_pattern(display, color, GD_EPAPER_SCREEN_BUFFER_SIZE);
+    wait_display(display, GD_EPAPER_BUSY_TRANSFER); // wait until execute
+}
+
+void gd_epaper_clear(gd_epaper_display_dev *display, gd_epaper_color color)
+{
+    gd_epaper_send_init(display);
+    gd_epaper_send_fill(display, color);
+
+    gd_epaper_send_refresh(display);
+    send_finish(display);
+}
+
+int8_t gd_epaper_send_compressed(gd_epaper_display_dev *display, const uint8_t *data, size_t size)
+{
+    int8_t rslt;
+
+    if (data == NULL)
+    {
+        return GD_EPAPER_E_NULL_PTR;
+    }
+    if (is_transposed(display))
+    {
+        return GD_EPAPER_E_NOT_SUPPORTED; // frame can't be transposed in stream
+    }
+    send_old_data(display, GD_EPAPER_SCREEN_BUFFER_SIZE);
+
+    write_command(display, GD_EPAPER_DATA_NEW); // Transfer new data, decompressed on the fly
+    rslt = rle_decode(data, size, GD_EPAPER_SCREEN_BUFFER_SIZE, rle_sink_display, display);
+    wait_display(display, GD_EPAPER_BUSY_TRANSFER); // wait until execute
+    return rslt;
+}
+
+int8_t gd_epaper_update_screen_compressed(gd_epaper_display_dev *display, const uint8_t *data, size_t size)
+{
+    int8_t rslt;
+
+    if (data == NULL)
+    {
+        return GD_EPAPER_E_NULL_PTR;
+    }
+    if (is_transposed(display))
     {
-        write_data(display, (uint8_t)0x00); // zero send required here
+        return GD_EPAPER_E_NOT_SUPPORTED;
     }
+    // decode twice rather than refresh panel with broken frame
+    rslt = rle_decode(data, size, GD_EPAPER_SCREEN_BUFFER_SIZE, rle_sink_none, NULL);
+    if (rslt != GD_EPAPER_OK)
+    {
+        return rslt;
+    }
+    gd_epaper_send_init(display);
+    rslt = gd_epaper_send_compressed(display, data, size);
+
+    gd_epaper_send_refresh(display);
+    send_finish(display);
+    return rslt;
+}
+
+int8_t gd_epaper_update_region(gd_epaper_display_dev *display, const gd_epaper_region *region)
+{
+    gd_epaper_region ram;
 
-    write_command(display, 0x13); // Transfer new data
-    for (i = 0; i < GD_EPAPER_SCREEN_BUFFER_SIZE; i++)
+    if (region == NULL)
     {
-        write_data(display, display->screen_buffer[i]);
+        return GD_EPAPER_E_NULL_PTR;
     }
-    wait_display(display); // wait until execute
+    ram = region_to_ram(display, region);
+    if (!region_align(&ram))
+    {
+        return GD_EPAPER_E_INVALID_ARG;
+    }
+
+    gd_epaper_send_init(display);
+    send_partial_in(display, &ram);
+
+    send_old_data(display, (size_t)(ram.width / 8) * ram.height);
+    write_command(display, GD_EPAPER_DATA_NEW); // Transfer new data
+    send_plane(display, display->screen_buffer, &ram);
+    wait_display(display, GD_EPAPER_BUSY_TRANSFER);
+
+    gd_epaper_send_refresh(display);
+    write_command(display, GD_EPAPER_PARTIAL_OUT);
+    send_finish(display);
+    return GD_EPAPER_OK;
 }
 
-void gd_epaper_update_screen(gd_epaper_display_dev *display)
+int8_t gd_epaper_fill_region(gd_epaper_display_dev *display, const gd_epaper_region *region, gd_epaper_color color)
 {
+    gd_epaper_region ram;
+    size_t count;
+
+    if (region == NULL)
+    {
+        return GD_EPAPER_E_NULL_PTR;
+    }
+    ram = region_to_ram(display, region);
+    if (!region_valid(&ram))
+    {
+        return GD_EPAPER_E_INVALID_ARG;
+    }
+    count = (size_t)(ram.width / 8) * ram.height;
+
     gd_epaper_send_init(display);
-    gd_epaper_send_buffer(display);
+    send_partial_in(display, &ram);
+
+    send_old_data(display, count);
+    write_command(display, GD_EPAPER_DATA_NEW); // Transfer new data
+    write_data_pattern(display, color, count);
+    wait_display(display, GD_EPAPER_BUSY_TRANSFER);
 
     gd_epaper_send_refresh(display);
-    gd_epaper_send_sleep(display);
+    write_command(display, GD_EPAPER_PARTIAL_OUT);
+    send_finish(display);
+    return GD_EPAPER_OK;
 }
 #endif
@@ -15,6 +15,22 @@
 extern "C"
 {
 #endif
+    /*!
+     * @brief Function to get screen buffer width for display rotation
+     *
+     * @param[in] display          : Display device pointer
+     *
+     * @retval Screen buffer width in pixels
+     */
+    uint16_t gd_epaper_get_width(const gd_epaper_display_dev *display);
+    /*!
+     * @brief Function to get screen buffer height for display rotation
+     *
+     * @param[in] display          : Display device pointer
+     *
+     * @retval Screen buffer height in pixels
+     */
+    uint16_t gd_epaper_get_height(const gd_epaper_display_dev *display);
     /*!
      * @brief Function to wakeup and init display
      *
@@ -33,6 +49,12 @@ extern "C"
      * @param[in] display          : Display device pointer
      */
     void gd_epaper_send_sleep(gd_epaper_display_dev *display);
+    /*!
+     * @brief Function to send power off command without deep sleep, controller RAM is retained
+     *
+     * @param[in] display          : Display device pointer
+     */
+    void gd_epaper_send_power_off(gd_epaper_display_dev *display);
     /*!
      * @brief Function to send buffer to display
      *
@@ -40,12 +62,113 @@ extern "C"
      */
     void gd_epaper_send_buffer(gd_epaper_display_dev *display);
     /*!
-     * @brief Full refresh display function. Init display, send and draw screen buffer, and send display to deep sleep
+     * @brief Function to send any screen buffer sized frame to display, e.g. pre-rendered frame from flash
+     *
+     * @param[in] display          : Display device pointer
+     * @param[in] frame            : GD_EPAPER_SCREEN_BUFFER_SIZE bytes frame
+     */
+    void gd_epaper_send_frame(gd_epaper_display_dev *display, const uint8_t *frame);
+    /*!
+     * @brief Full refresh display function. Init display, send and draw screen buffer, and send display to deep sleep.
+     * In fast/partial refresh mode display is only powered off, so RAM is retained for next partial refresh
      *
      * @param[in] display          : Display device pointer
      *
      */
     void gd_epaper_update_screen(gd_epaper_display_dev *display);
+    /*!
+     * @brief Partial refresh display function. Init display, send and draw screen buffer region,
+     * and send display to deep sleep. Region is extended to byte aligned controller window
+     *
+     * @param[in] display          : Display device pointer
+     * @param[in] region           : Screen buffer region, clipped to screen
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_NULL_PTR      -> Region is NULL.
+     * @retval GD_EPAPER_E_INVALID_ARG   -> Region is empty or outside screen.
+     */
+    int8_t gd_epaper_update_region(gd_epaper_display_dev *display, const gd_epaper_region *region);
+    /*!
+     * @brief Function to send single color screen to display, screen buffer is not used
+     *
+     * @param[in] display          : Display device pointer
+     * @param[in] color            : Fill color
+     */
+    void gd_epaper_send_fill(gd_epaper_display_dev *display, gd_epaper_color color);
+    /*!
+     * @brief Full refresh display with single color. Init display, send color, draw and send display to deep sleep.
+     * Screen buffer is not used and not changed
+     *
+     * @param[in] display          : Display device pointer
+     * @param[in] color            : Fill color
+     */
+    void gd_epaper_clear(gd_epaper_display_dev *display, gd_epaper_color color);
+    /*!
+     * @brief Partial refresh display region with single color. Init display, fill region, draw and send display to deep sleep.
+     * Screen buffer is not used and not changed
+     *
+     * @param[in] display          : Display device pointer
+     * @param[in] region           : Screen region, x and width (y and height on 90/270 rotation) must be multiple of 8
+     * @param[in] color            : Fill color
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_NULL_PTR      -> Region is NULL.
+     * @retval GD_EPAPER_E_INVALID_ARG   -> Region is empty, outside screen or not aligned.
+     */
+    int8_t gd_epaper_fill_region(gd_epaper_display_dev *display, const gd_epaper_region *region, gd_epaper_color color);
+    /*!
+     * @brief Function to compress frame (screen buffer sized image) to RLE format. Can be used on host to prepare
+     * frames stored in flash
+     *
+     * @param[in] frame            : Frame to compress
+     * @param[in] frame_size       : Frame size in bytes
+     * @param[out] out             : Compressed frame output, GD_EPAPER_COMPRESS_BOUND(frame_size) bytes always enough
+     * @param[in] out_size         : Output buffer size
+     *
+     * @retval Compressed frame size, 0 if output buffer is too small
+     */
+    size_t gd_epaper_compress_frame(const uint8_t *frame, size_t frame_size, uint8_t *out, size_t out_size);
+    /*!
+     * @brief Function to decompress frame to memory, e.g. to use it as screen buffer base layer
+     *
+     * @param[in] data             : Compressed frame
+     * @param[in] size             : Compressed frame size
+     * @param[out] frame           : Decompressed frame output
+     * @param[in] frame_size       : Decompressed frame size
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_NULL_PTR      -> Data or frame is NULL.
+     * @retval GD_EPAPER_E_CORRUPTED     -> Frame is corrupted, output is truncated or padded with white.
+     */
+    int8_t gd_epaper_decompress_frame(const uint8_t *data, size_t size, uint8_t *frame, size_t frame_size);
+    /*!
+     * @brief Function to send compressed frame to display, frame decompressed in small chunks directly to SPI.
+     * Screen buffer is not used
+     *
+     * @param[in] display          : Display device pointer
+     * @param[in] data             : Compressed frame
+     * @param[in] size             : Compressed frame size
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_NULL_PTR      -> Data is NULL.
+     * @retval GD_EPAPER_E_CORRUPTED     -> Frame is corrupted, sent frame is truncated or padded with white.
+     * @retval GD_EPAPER_E_NOT_SUPPORTED -> 90/270 rotation, decompress frame to screen buffer instead.
+     */
+    int8_t gd_epaper_send_compressed(gd_epaper_display_dev *display, const uint8_t *data, size_t size);
+    /*!
+     * @brief Full refresh display function with compressed frame. Init display, send and draw compressed frame,
+     * and send display to deep sleep
+     *
+     * @param[in] display          : Display device pointer
+     * @param[in] data             : Compressed frame
+     * @param[in] size             : Compressed frame size
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_NULL_PTR      -> Data is NULL.
+     * @retval GD_EPAPER_E_CORRUPTED     -> Frame is corrupted, display is not touched.
+     * @retval GD_EPAPER_E_NOT_SUPPORTED -> 90/270 rotation, display is not touched.
+     */
+    int8_t gd_epaper_update_screen_compressed(gd_epaper_display_dev *display, const uint8_t *data, size_t size);
 
 #ifdef __cplusplus
 }
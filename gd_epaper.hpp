@@ -0,0 +1,365 @@
+/*!
+ * Header-only C++20 front end for GooDisplay e-paper screens based on UC8179 ic driver.
+ * Panel geometry and init script are constexpr traits, bus and GPIO are static policy calls,
+ * so whole transfer loop is inlined and specialized for every board
+ */
+
+#ifndef _GD_EPAPER_HPP_
+#define _GD_EPAPER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "./gd_epaper_defs.h"
+
+namespace gd_epaper
+{
+    /*!
+     * @brief Single init script command
+     */
+    struct Command
+    {
+        uint8_t command;
+        uint8_t length;
+        std::array<uint8_t, 4> data;
+        /* Wait BUSY after command */
+        bool wait;
+    };
+
+    /*!
+     * @brief 7.5 inch 800x480 GDEY075T7 panel traits
+     */
+    struct Gdey075t7
+    {
+        static constexpr uint16_t width = 800;
+        static constexpr uint16_t height = 480;
+        static constexpr size_t buffer_size = width * height / 8;
+        using buffer_type = std::array<uint8_t, buffer_size>;
+
+        static constexpr std::array<Command, 7> init_script = {{
+            {GD_EPAPER_POWER_SETTINGS_1, 4, {GD_EPAPER_POWER_SETTINGS_2, GD_EPAPER_VGH_VGL, GD_EPAPER_VDH, GD_EPAPER_VDL}, false},
+            {GD_EPAPER_POWER_ON, 0, {}, true},
+            {GD_EPAPER_PANNEL_SETTING_1, 1, {GD_EPAPER_PANNEL_SETTING_2}, false},
+            {GD_EPAPER_PANNEL_SETTING_3, 4, {GD_EPAPER_HRES_BYTE_HIGH, GD_EPAPER_HRES_BYTE_LOW, GD_EPAPER_VRES_BYTE_HIGH, GD_EPAPER_VRES_BYTE_LOW}, false},
+            {GD_EPAPER_PANNEL_SETTING_4, 1, {GD_EPAPER_PANNEL_SETTING_5}, false},
+            {GD_EPAPER_VCOM_1, 2, {GD_EPAPER_VCOM_2, GD_EPAPER_VCOM_3}, false},
+            {GD_EPAPER_TCON_1, 1, {GD_EPAPER_TCON_2}, false},
+        }};
+    };
+
+    /*!
+     * @brief Constexpr lookup tables
+     */
+    namespace lut
+    {
+        /* Pixel x % 8 -> bit mask in MSB first byte */
+        inline constexpr std::array<uint8_t, 8> bit_mask = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
+
+        /* Byte -> byte with reversed bit order, for software horizontal mirroring */
+        inline constexpr std::array<uint8_t, 256> reverse_bits = []
+        {
+            std::array<uint8_t, 256> table{};
+            for (unsigned i = 0; i < 256; i++)
+            {
+                uint8_t value = 0;
+                for (unsigned bit = 0; bit < 8; bit++)
+                {
+                    value |= ((i >> bit) & 1U) << (7 - bit);
+                }
+                table[i] = value;
+            }
+            return table;
+        }();
+
+        /* 4 pixels of 2bpp grayscale byte -> (high bit plane nibble << 4) | low bit plane nibble */
+        inline constexpr std::array<uint8_t, 256> plane_pack = []
+        {
+            std::array<uint8_t, 256> table{};
+            for (unsigned i = 0; i < 256; i++)
+            {
+                uint8_t high = 0;
+                uint8_t low = 0;
+                for (unsigned pixel = 0; pixel < 4; pixel++)
+                {
+                    unsigned gray = (i >> (6 - pixel * 2)) & 0x03;
+                    high |= ((gray >> 1) & 1U) << (3 - pixel);
+                    low |= (gray & 1U) << (3 - pixel);
+                }
+                table[i] = (uint8_t)((high << 4) | low);
+            }
+            return table;
+        }();
+
+        /* Constant pattern block for fills */
+        template <uint8_t Value>
+        inline constexpr std::array<uint8_t, GD_EPAPER_PATTERN_BLOCK_SIZE> pattern = []
+        {
+            std::array<uint8_t, GD_EPAPER_PATTERN_BLOCK_SIZE> block{};
+            block.fill(Value);
+            return block;
+        }();
+    }
+
+    /*!
+     * @brief Function to split 2bpp grayscale image to two 1bpp planes
+     *
+     * @param[in] gray             : 2bpp image, 4 pixels per byte, MSB first
+     * @param[out] high            : High bit plane, gray.size() / 2 bytes
+     * @param[out] low             : Low bit plane, gray.size() / 2 bytes
+     */
+    inline void pack_planes(std::span<const uint8_t> gray, std::span<uint8_t> high, std::span<uint8_t> low)
+    {
+        for (size_t i = 0; i + 1 < gray.size() && i / 2 < high.size() && i / 2 < low.size(); i += 2)
+        {
+            uint8_t first = lut::plane_pack[gray[i]];
+            uint8_t second = lut::plane_pack[gray[i + 1]];
+            high[i / 2] = (uint8_t)((first & 0xF0) | (second >> 4));
+            low[i / 2] = (uint8_t)((first << 4) | (second & 0x0F));
+        }
+    }
+
+    /*!
+     * @brief Framebuffer view, drawing helpers over panel sized buffer
+     */
+    template <typename PanelTraits>
+    class FrameView
+    {
+    public:
+        constexpr explicit FrameView(std::span<uint8_t, PanelTraits::buffer_size> buffer) : buffer_(buffer) {}
+
+        constexpr void set_pixel(uint16_t x, uint16_t y, gd_epaper_color color)
+        {
+            if (x >= PanelTraits::width || y >= PanelTraits::height)
+            {
+                return; // Don't write outside the buffer
+            }
+            uint8_t &byte = buffer_[(size_t)y * (PanelTraits::width / 8) + x / 8];
+            byte = (color == GD_EPAPER_BLACK) ? (uint8_t)(byte | lut::bit_mask[x % 8]) : (uint8_t)(byte & ~lut::bit_mask[x % 8]);
+        }
+        constexpr bool get_pixel(uint16_t x, uint16_t y) const
+        {
+            return x < PanelTraits::width && y < PanelTraits::height &&
+                   (buffer_[(size_t)y * (PanelTraits::width / 8) + x / 8] & lut::bit_mask[x % 8]) != 0;
+        }
+        constexpr void fill(gd_epaper_color color)
+        {
+            for (auto &byte : buffer_)
+            {
+                byte = (uint8_t)color;
+            }
+        }
+        constexpr std::span<const uint8_t, PanelTraits::buffer_size> data() const { return buffer_; }
+
+    private:
+        std::span<uint8_t, PanelTraits::buffer_size> buffer_;
+    };
+
+    /*!
+     * @brief Bit banged SPI bus policy, Pins must provide static cs(bool), clk(bool), mosi(bool)
+     */
+    template <typename Pins>
+    struct SoftwareSpi
+    {
+        static void write(std::span<const uint8_t> data)
+        {
+            for (uint8_t value : data)
+            {
+                Pins::cs(false);
+                for (uint8_t i = 0; i < 8; i++)
+                {
+                    Pins::clk(false);
+                    Pins::mosi((value & 0x80) != 0);
+                    value = (uint8_t)(value << 1);
+                    Pins::clk(true);
+                }
+                Pins::cs(true);
+            }
+        }
+    };
+
+    /*!
+     * @brief E-paper display over 4-wire SPI
+     *
+     * BusPolicy must provide:
+     *   static void write(std::span<const uint8_t> data)  - send bytes, any length
+     * PinPolicy must provide:
+     *   static void dc(bool data)                         - D/C pin, true for data
+     *   static void reset(bool high)                      - RESET pin
+     *   static bool busy()                                - true while BUSY pin is low
+     *   static void delay_us(uint32_t period)             - microseconds delay
+     * PinPolicy may provide:
+     *   static uint32_t wait_busy(uint32_t timeout_us)    - wait BUSY release edge, returns waited microseconds
+     */
+    template <typename PanelTraits, typename BusPolicy, typename PinPolicy>
+    class Epaper
+    {
+    public:
+        using traits = PanelTraits;
+        using buffer_type = typename PanelTraits::buffer_type;
+        using frame_span = std::span<const uint8_t, PanelTraits::buffer_size>;
+
+        /* Learned BUSY durations in microseconds, same meaning as in gd_epaper_display_dev */
+        std::array<uint32_t, GD_EPAPER_BUSY_OP_COUNT> busy_estimate_us{};
+
+        /*!
+         * @brief Wakeup and init display with traits init script
+         */
+        void init()
+        {
+            PinPolicy::reset(false); //  IC reset
+            PinPolicy::delay_us(15);
+            PinPolicy::reset(true);
+            PinPolicy::delay_us(15);
+            for (const Command &step : PanelTraits::init_script)
+            {
+                command(step.command);
+                if (step.length > 0)
+                {
+                    data(std::span<const uint8_t>(step.data.data(), step.length));
+                }
+                if (step.wait)
+                {
+                    wait(GD_EPAPER_BUSY_POWER_ON);
+                }
+            }
+        }
+        /*!
+         * @brief Send frame to display
+         */
+        void send(frame_span frame)
+        {
+            command(GD_EPAPER_DATA_OLD); // Transfer old data
+            pattern<0x00>(PanelTraits::buffer_size);
+            command(GD_EPAPER_DATA_NEW); // Transfer new data
+            data(frame);
+            wait(GD_EPAPER_BUSY_TRANSFER);
+        }
+        /*!
+         * @brief Send single color screen to display
+         */
+        void send_fill(gd_epaper_color color)
+        {
+            command(GD_EPAPER_DATA_OLD);
+            pattern<0x00>(PanelTraits::buffer_size);
+            command(GD_EPAPER_DATA_NEW);
+            if (color == GD_EPAPER_BLACK)
+            {
+                pattern<GD_EPAPER_BLACK>(PanelTraits::buffer_size);
+            }
+            else
+            {
+                pattern<GD_EPAPER_WHITE>(PanelTraits::buffer_size);
+            }
+            wait(GD_EPAPER_BUSY_TRANSFER);
+        }
+        /*!
+         * @brief Send display refresh command
+         */
+        void refresh()
+        {
+            command(GD_EPAPER_DISPLAY_REFRESH);
+            PinPolicy::delay_us(20); //!!! The delay here is necessary, 20uS at least!!!
+            wait(GD_EPAPER_BUSY_REFRESH);
+        }
+        /*!
+         * @brief Send deep sleep command
+         */
+        void sleep()
+        {
+            static constexpr uint8_t border[] = {0xF7};
+            static constexpr uint8_t check[] = {GD_EPAPER_DEEP_SLEEP_CHECK};
+            command(GD_EPAPER_VCOM_1);
+            data(border);
+            command(GD_EPAPER_POWER_OFF); // power off
+            wait(GD_EPAPER_BUSY_POWER_OFF);
+            command(GD_EPAPER_DEEP_SLEEP); // deep sleep
+            data(check);
+        }
+        /*!
+         * @brief Full refresh: init, send and draw frame, deep sleep
+         */
+        void update(frame_span frame)
+        {
+            init();
+            send(frame);
+            refresh();
+            sleep();
+        }
+        /*!
+         * @brief Full refresh with single color, no framebuffer needed
+         */
+        void clear(gd_epaper_color color)
+        {
+            init();
+            send_fill(color);
+            refresh();
+            sleep();
+        }
+
+    private:
+        static void command(uint8_t value)
+        {
+            const uint8_t buff[] = {value};
+            PinPolicy::dc(false);
+            BusPolicy::write(buff);
+        }
+        static void data(std::span<const uint8_t> values)
+        {
+            PinPolicy::dc(true);
+            BusPolicy::write(values);
+        }
+        template <uint8_t Value>
+        static void pattern(size_t count)
+        {
+            PinPolicy::dc(true);
+            for (; count >= GD_EPAPER_PATTERN_BLOCK_SIZE; count -= GD_EPAPER_PATTERN_BLOCK_SIZE)
+            {
+                BusPolicy::write(lut::pattern<Value>);
+            }
+            if (count > 0)
+            {
+                BusPolicy::write(std::span<const uint8_t>(lut::pattern<Value>.data(), count));
+            }
+        }
+        /*!
+         * @brief Adaptive BUSY wait, uses same estimate helpers as C driver wait_display
+         */
+        void wait(gd_epaper_busy_op op)
+        {
+            uint32_t estimate = busy_estimate_us[op];
+            uint32_t poll = gd_epaper_busy_poll_us(estimate);
+            uint32_t elapsed = gd_epaper_busy_sleep_us(estimate);
+            uint32_t edge_wait = 0;
+            uint32_t polls = 0;
+
+            if (elapsed > 0)
+            {
+                PinPolicy::delay_us(elapsed);
+            }
+            if constexpr (requires { PinPolicy::wait_busy(uint32_t{}); })
+            {
+                // platform waits for BUSY edge, polling below only confirms it
+                edge_wait = PinPolicy::wait_busy(GD_EPAPER_BUSY_TIMEOUT_US);
+                elapsed += edge_wait;
+            }
+            for (;;)
+            {
+                command(GD_EPAPER_DISPLAY_WAIT);
+                if (!PinPolicy::busy())
+                {
+                    break;
+                }
+                PinPolicy::delay_us(poll);
+                elapsed += poll;
+                polls++;
+            }
+            PinPolicy::delay_us(200); // minimum 100 us
+
+            busy_estimate_us[op] = gd_epaper_busy_estimate_us(estimate, elapsed, edge_wait, polls);
+        }
+    };
+}
+
+#endif
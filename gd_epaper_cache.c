@@ -0,0 +1,246 @@
+#include <string.h>
+
+#include "gd_epaper_cache.h"
+
+#ifdef GD_EPAPER_USE_FRAME_CACHE_MMAP
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define CACHE_HEADER_SIZE 12 // magic, version, count
+#define CACHE_ENTRY_SIZE 16  // key, flags, offset, size
+
+/*!
+ * @brief Internal function to read little endian uint32 from unaligned memory
+ */
+static uint32_t read_u32(const uint8_t *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+/*!
+ * @brief Internal function to read frame entry from memory mapped file, entry must be validated on open
+ */
+static void read_entry(const gd_epaper_frame_cache *cache, size_t index, gd_epaper_cached_frame *frame)
+{
+    const uint8_t *entry = cache->map + CACHE_HEADER_SIZE + index * CACHE_ENTRY_SIZE;
+
+    frame->key = read_u32(entry);
+    frame->flags = read_u32(entry + 4);
+    frame->data = cache->map + read_u32(entry + 8);
+    frame->size = read_u32(entry + 12);
+}
+
+void gd_epaper_frame_cache_init(gd_epaper_frame_cache *cache, const gd_epaper_cached_frame *frames, size_t count)
+{
+    cache->frames = frames;
+    cache->count = count;
+    cache->map = NULL;
+    cache->map_size = 0;
+}
+
+int8_t gd_epaper_frame_cache_find(const gd_epaper_frame_cache *cache, uint32_t key, gd_epaper_cached_frame *frame)
+{
+    if (cache == NULL || frame == NULL)
+    {
+        return GD_EPAPER_E_NULL_PTR;
+    }
+    for (size_t i = 0; i < cache->count; i++)
+    {
+        if (cache->map != NULL)
+        {
+            if (read_u32(cache->map + CACHE_HEADER_SIZE + i * CACHE_ENTRY_SIZE) == key)
+            {
+                read_entry(cache, i, frame);
+                return GD_EPAPER_OK;
+            }
+        }
+        else if (cache->frames[i].key == key)
+        {
+            *frame = cache->frames[i];
+            return GD_EPAPER_OK;
+        }
+    }
+    return GD_EPAPER_E_NOT_FOUND;
+}
+
+int8_t gd_epaper_cached_frame_load(const gd_epaper_cached_frame *frame, uint8_t *buffer)
+{
+    if (frame == NULL || buffer == NULL)
+    {
+        return GD_EPAPER_E_NULL_PTR;
+    }
+    if (frame->flags & GD_EPAPER_FRAME_COMPRESSED)
+    {
+        return gd_epaper_decompress_frame(frame->data, frame->size, buffer, GD_EPAPER_SCREEN_BUFFER_SIZE);
+    }
+    if (frame->size != GD_EPAPER_SCREEN_BUFFER_SIZE)
+    {
+        return GD_EPAPER_E_INVALID_ARG;
+    }
+    memcpy(buffer, frame->data, GD_EPAPER_SCREEN_BUFFER_SIZE);
+    return GD_EPAPER_OK;
+}
+
+int8_t gd_epaper_cached_frame_send(gd_epaper_display_dev *display, const gd_epaper_cached_frame *frame)
+{
+    if (frame == NULL)
+    {
+        return GD_EPAPER_E_NULL_PTR;
+    }
+    if (frame->flags & GD_EPAPER_FRAME_COMPRESSED)
+    {
+        return gd_epaper_send_compressed(display, frame->data, frame->size);
+    }
+    if (frame->size != GD_EPAPER_SCREEN_BUFFER_SIZE)
+    {
+        return GD_EPAPER_E_INVALID_ARG;
+    }
+    gd_epaper_send_frame(display, frame->data);
+    return GD_EPAPER_OK;
+}
+
+int8_t gd_epaper_update_screen_cached(gd_epaper_display_dev *display, const gd_epaper_frame_cache *cache, uint32_t key)
+{
+    gd_epaper_cached_frame frame;
+    int8_t rslt;
+
+    rslt = gd_epaper_frame_cache_find(cache, key, &frame);
+    if (rslt != GD_EPAPER_OK)
+    {
+        return rslt;
+    }
+    if (frame.flags & GD_EPAPER_FRAME_COMPRESSED)
+    {
+        // checks arguments before display init
+        return gd_epaper_update_screen_compressed(display, frame.data, frame.size);
+    }
+    if (frame.size != GD_EPAPER_SCREEN_BUFFER_SIZE)
+    {
+        return GD_EPAPER_E_INVALID_ARG; // don't refresh stale controller RAM
+    }
+    gd_epaper_send_init(display);
+    gd_epaper_send_frame(display, frame.data);
+
+    gd_epaper_send_refresh(display);
+    gd_epaper_send_sleep(display);
+    return GD_EPAPER_OK;
+}
+
+#ifdef GD_EPAPER_USE_FRAME_CACHE_MMAP
+/*!
+ * @brief Internal function to write little endian uint32 to file
+ */
+static bool write_u32(FILE *file, uint32_t value)
+{
+    uint8_t data[4] = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+    return fwrite(data, sizeof(data), 1, file) == 1;
+}
+
+int8_t gd_epaper_frame_cache_open(gd_epaper_frame_cache *cache, const char *path)
+{
+    struct stat st;
+    const uint8_t *entry;
+    uint32_t offset;
+    uint32_t size;
+    void *map;
+    size_t count;
+    int fd;
+
+    if (cache == NULL || path == NULL)
+    {
+        return GD_EPAPER_E_NULL_PTR;
+    }
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return GD_EPAPER_E_IO;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size < CACHE_HEADER_SIZE)
+    {
+        close(fd);
+        return GD_EPAPER_E_IO;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // mapping keeps file referenced
+    if (map == MAP_FAILED)
+    {
+        return GD_EPAPER_E_IO;
+    }
+    gd_epaper_frame_cache_init(cache, NULL, 0);
+    cache->map = (const uint8_t *)map;
+    cache->map_size = (size_t)st.st_size;
+
+    // validate header and all entries once, lookups trust them
+    count = read_u32(cache->map + 8);
+    if (read_u32(cache->map) != GD_EPAPER_FRAME_CACHE_MAGIC ||
+        read_u32(cache->map + 4) != GD_EPAPER_FRAME_CACHE_VERSION ||
+        count > (cache->map_size - CACHE_HEADER_SIZE) / CACHE_ENTRY_SIZE)
+    {
+        gd_epaper_frame_cache_close(cache);
+        return GD_EPAPER_E_CORRUPTED;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        // check as integers, pointer outside mapping can't be even formed
+        entry = cache->map + CACHE_HEADER_SIZE + i * CACHE_ENTRY_SIZE;
+        offset = read_u32(entry + 8);
+        size = read_u32(entry + 12);
+        if (offset > cache->map_size || size > cache->map_size - offset)
+        {
+            gd_epaper_frame_cache_close(cache);
+            return GD_EPAPER_E_CORRUPTED;
+        }
+    }
+    cache->count = count;
+    return GD_EPAPER_OK;
+}
+
+void gd_epaper_frame_cache_close(gd_epaper_frame_cache *cache)
+{
+    if (cache->map != NULL)
+    {
+        munmap((void *)cache->map, cache->map_size);
+    }
+    gd_epaper_frame_cache_init(cache, NULL, 0);
+}
+
+int8_t gd_epaper_frame_cache_save(const char *path, const gd_epaper_cached_frame *frames, size_t count)
+{
+    FILE *file;
+    uint32_t offset = CACHE_HEADER_SIZE + count * CACHE_ENTRY_SIZE;
+    bool ok;
+
+    if (path == NULL || (frames == NULL && count > 0))
+    {
+        return GD_EPAPER_E_NULL_PTR;
+    }
+    file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        return GD_EPAPER_E_IO;
+    }
+    ok = write_u32(file, GD_EPAPER_FRAME_CACHE_MAGIC) &&
+         write_u32(file, GD_EPAPER_FRAME_CACHE_VERSION) &&
+         write_u32(file, (uint32_t)count);
+    for (size_t i = 0; ok && i < count; i++)
+    {
+        ok = write_u32(file, frames[i].key) &&
+             write_u32(file, frames[i].flags) &&
+             write_u32(file, offset) &&
+             write_u32(file, (uint32_t)frames[i].size);
+        offset += (uint32_t)frames[i].size;
+    }
+    for (size_t i = 0; ok && i < count; i++)
+    {
+        ok = frames[i].size == 0 || fwrite(frames[i].data, frames[i].size, 1, file) == 1;
+    }
+    if (fclose(file) != 0)
+    {
+        ok = false;
+    }
+    return ok ? GD_EPAPER_OK : GD_EPAPER_E_IO;
+}
+#endif
@@ -0,0 +1,154 @@
+/*!
+ * Pre-rendered frame cache for GooDisplay e-paper screens based on UC8179 ic driver
+ */
+
+#ifndef _GD_EPAPER_CACHE_H_
+#define _GD_EPAPER_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "./gd_epaper.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define GD_EPAPER_FRAME_RAW 0x00        // GD_EPAPER_SCREEN_BUFFER_SIZE bytes frame
+#define GD_EPAPER_FRAME_COMPRESSED 0x01 // frame compressed with gd_epaper_compress_frame
+
+// Cache file format (all values are little endian uint32):
+// magic, version, frames count, frames count * (key, flags, data offset, data size), frames data
+#define GD_EPAPER_FRAME_CACHE_MAGIC 0x43464447 // "GDFC"
+#define GD_EPAPER_FRAME_CACHE_VERSION 1
+
+    /*!
+     * @brief Pre-rendered frame
+     */
+    typedef struct
+    {
+        /* Unique frame key */
+        uint32_t key;
+        /* GD_EPAPER_FRAME_RAW or GD_EPAPER_FRAME_COMPRESSED */
+        uint32_t flags;
+        /* Frame data */
+        const uint8_t *data;
+        /* Frame data size */
+        size_t size;
+    } gd_epaper_cached_frame;
+
+    /*!
+     * @brief Keyed store of pre-rendered frames, ROM table or memory mapped file
+     */
+    typedef struct
+    {
+        /* Frames table, e.g. const array in flash */
+        const gd_epaper_cached_frame *frames;
+        /* Frames table length */
+        size_t count;
+        /* Memory mapped cache file, NULL if frames table is used */
+        const uint8_t *map;
+        /* Memory mapped cache file size */
+        size_t map_size;
+    } gd_epaper_frame_cache;
+
+    /*!
+     * @brief Function to init cache with frames table
+     *
+     * @param[out] cache           : Frame cache pointer
+     * @param[in] frames           : Frames table, must stay valid while cache is used
+     * @param[in] count            : Frames table length
+     */
+    void gd_epaper_frame_cache_init(gd_epaper_frame_cache *cache, const gd_epaper_cached_frame *frames, size_t count);
+    /*!
+     * @brief Function to find frame by key. Frame data is not copied
+     *
+     * @param[in] cache            : Frame cache pointer
+     * @param[in] key              : Frame key
+     * @param[out] frame           : Found frame
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_NULL_PTR      -> Cache or frame is NULL.
+     * @retval GD_EPAPER_E_NOT_FOUND     -> No frame with such key.
+     */
+    int8_t gd_epaper_frame_cache_find(const gd_epaper_frame_cache *cache, uint32_t key, gd_epaper_cached_frame *frame);
+    /*!
+     * @brief Function to copy or decompress frame to buffer, e.g. to use it as base layer for dynamic content
+     *
+     * @param[in] frame            : Cached frame
+     * @param[out] buffer          : GD_EPAPER_SCREEN_BUFFER_SIZE bytes buffer
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_NULL_PTR      -> Frame or buffer is NULL.
+     * @retval GD_EPAPER_E_INVALID_ARG   -> Raw frame has wrong size.
+     * @retval GD_EPAPER_E_CORRUPTED     -> Compressed frame is corrupted.
+     */
+    int8_t gd_epaper_cached_frame_load(const gd_epaper_cached_frame *frame, uint8_t *buffer);
+    /*!
+     * @brief Function to send cached frame directly to display, screen buffer is not used
+     *
+     * @param[in] display          : Display device pointer
+     * @param[in] frame            : Cached frame
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_NULL_PTR      -> Frame is NULL.
+     * @retval GD_EPAPER_E_INVALID_ARG   -> Raw frame has wrong size.
+     * @retval GD_EPAPER_E_CORRUPTED     -> Compressed frame is corrupted.
+     * @retval GD_EPAPER_E_NOT_SUPPORTED -> Compressed frame with 90/270 rotation, load it to screen buffer instead.
+     */
+    int8_t gd_epaper_cached_frame_send(gd_epaper_display_dev *display, const gd_epaper_cached_frame *frame);
+    /*!
+     * @brief Full refresh display function with cached frame. Init display, send and draw frame,
+     * and send display to deep sleep
+     *
+     * @param[in] display          : Display device pointer
+     * @param[in] cache            : Frame cache pointer
+     * @param[in] key              : Frame key
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_NOT_FOUND     -> No frame with such key, display is not touched.
+     * @retval GD_EPAPER_E_INVALID_ARG   -> Raw frame has wrong size, display is not touched.
+     * @retval GD_EPAPER_E_CORRUPTED     -> Compressed frame is corrupted, display is not touched.
+     * @retval GD_EPAPER_E_NOT_SUPPORTED -> Compressed frame with 90/270 rotation, display is not touched.
+     */
+    int8_t gd_epaper_update_screen_cached(gd_epaper_display_dev *display, const gd_epaper_frame_cache *cache, uint32_t key);
+
+#ifdef GD_EPAPER_USE_FRAME_CACHE_MMAP
+    /*!
+     * @brief Function to memory map cache file
+     *
+     * @param[out] cache           : Frame cache pointer
+     * @param[in] path             : Cache file path
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_NULL_PTR      -> Cache or path is NULL.
+     * @retval GD_EPAPER_E_IO            -> File can't be opened or mapped.
+     * @retval GD_EPAPER_E_CORRUPTED     -> File has wrong format.
+     */
+    int8_t gd_epaper_frame_cache_open(gd_epaper_frame_cache *cache, const char *path);
+    /*!
+     * @brief Function to unmap cache file
+     *
+     * @param[in, out] cache       : Frame cache pointer
+     */
+    void gd_epaper_frame_cache_close(gd_epaper_frame_cache *cache);
+    /*!
+     * @brief Function to write frames to cache file
+     *
+     * @param[in] path             : Cache file path
+     * @param[in] frames           : Frames table
+     * @param[in] count            : Frames table length
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_NULL_PTR      -> Path or frames is NULL.
+     * @retval GD_EPAPER_E_IO            -> File can't be written.
+     */
+    int8_t gd_epaper_frame_cache_save(const char *path, const gd_epaper_cached_frame *frames, size_t count);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -15,6 +15,8 @@ extern "C"
 #define GD_EPAPER_USE_HARDWARE_SPI // use hardware SPI  instead software implementation
     // #define GD_EPAPER_USE_SOFTWARE_SPI // use software SPI
 
+// #define GD_EPAPER_USE_FRAME_CACHE_MMAP // load frame caches from memory mapped files, POSIX host builds only
+
 #ifndef GD_EPAPER_USE_3_WIRE_SPI // don't work with supplied hat adapter (i really tried)
 #define GD_EPAPER_USE_4_WIRE_SPI
 #endif
@@ -24,6 +26,38 @@ extern "C"
                   // and the electronic paper display supports 4 grayscale.
                   // manufacturer link: https://www.good-display.com/product/396.html
 
+#ifndef GD_EPAPER_SPI_CHUNK_SIZE
+#define GD_EPAPER_SPI_CHUNK_SIZE 4000 // maximum bytes in single spi_write_fptr call, keep below platform DMA limit
+#endif
+#ifndef GD_EPAPER_PATTERN_BLOCK_SIZE
+#define GD_EPAPER_PATTERN_BLOCK_SIZE 64 // constant pattern block size used for fills
+#endif
+
+#ifndef GD_EPAPER_STREAM_CHUNK_SIZE
+#define GD_EPAPER_STREAM_CHUNK_SIZE 512 // decompression chunk size, allocated on stack while sending compressed frame
+#endif
+
+// Compressed frame format (PackBits like RLE), sequence of:
+// control 0x00..0x7F - (control + 1) literal bytes follow
+// control 0x80..0xFF - next byte repeated ((control & 0x7F) + 3) times
+#define GD_EPAPER_RLE_LITERAL_MAX 128
+#define GD_EPAPER_RLE_RUN_MIN 3
+#define GD_EPAPER_RLE_RUN_MAX (0x7F + GD_EPAPER_RLE_RUN_MIN)
+// Worst case compressed size of size bytes frame
+#define GD_EPAPER_COMPRESS_BOUND(size) ((size) + ((size) + GD_EPAPER_RLE_LITERAL_MAX - 1) / GD_EPAPER_RLE_LITERAL_MAX)
+
+#define GD_EPAPER_OK INT8_C(0)
+#define GD_EPAPER_E_NULL_PTR INT8_C(-1)
+#define GD_EPAPER_E_INVALID_ARG INT8_C(-2)
+#define GD_EPAPER_E_CORRUPTED INT8_C(-3)
+#define GD_EPAPER_E_NOT_FOUND INT8_C(-4)
+#define GD_EPAPER_E_IO INT8_C(-5)
+#define GD_EPAPER_E_NOT_SUPPORTED INT8_C(-6)
+
+#define GD_EPAPER_MIRROR_NONE 0x00
+#define GD_EPAPER_MIRROR_X 0x01 // mirror screen buffer horizontally
+#define GD_EPAPER_MIRROR_Y 0x02 // mirror screen buffer vertically
+
 #ifdef GDEY075T7
 
 #define GD_EPAPER_WIDTH 800
@@ -46,6 +80,8 @@ extern "C"
 
 #define GD_EPAPER_PANNEL_SETTING_1 0X00 // PANNEL SETTING
 #define GD_EPAPER_PANNEL_SETTING_2 0x1F // KW-3f   KWR-2F BWROTP 0f BWOTP 1f
+#define GD_EPAPER_PANNEL_UD 0x08  // gate scan direction bit of panel setting, 1 - up (native)
+#define GD_EPAPER_PANNEL_SHL 0x04 // source shift direction bit of panel setting, 1 - right (native)
 #define GD_EPAPER_PANNEL_SETTING_3 0x61 // tres
 
 #define GD_EPAPER_PANNEL_SETTING_4 0x15
@@ -58,10 +94,46 @@ extern "C"
 #define GD_EPAPER_TCON_1 0X60 // TCON SETTING
 #define GD_EPAPER_TCON_2 0x22
 
+#define GD_EPAPER_VCOM_N2OCP 0x08 // copy new data to old data after refresh, keeps displayed frame in old data RAM
+
+#define GD_EPAPER_CASCADE 0xE0 // CASCADE SETTING
+#define GD_EPAPER_CASCADE_TSFIX 0x02
+#define GD_EPAPER_FORCE_TEMP 0xE5 // FORCE TEMPERATURE, selects faster OTP waveform
+#define GD_EPAPER_FORCE_TEMP_FAST 0x5A
+#define GD_EPAPER_FORCE_TEMP_PARTIAL 0x6E
+
+#define GD_EPAPER_POWER_OFF 0x02
+#define GD_EPAPER_DEEP_SLEEP 0x07
+#define GD_EPAPER_DEEP_SLEEP_CHECK 0xA5
+
+#define GD_EPAPER_DATA_OLD 0x10 // Transfer old data
+#define GD_EPAPER_DATA_NEW 0x13 // Transfer new data
+
 #define GD_EPAPER_DISPLAY_REFRESH 0x12
 
+#define GD_EPAPER_PARTIAL_WINDOW 0x90 // Partial window, horizontal bounds must be byte aligned
+#define GD_EPAPER_PARTIAL_IN 0x91
+#define GD_EPAPER_PARTIAL_OUT 0x92
+#define GD_EPAPER_PARTIAL_SCAN 0x01 // PT_SCAN
+
 #define GD_EPAPER_DISPLAY_WAIT 0x71
 
+#ifndef GD_EPAPER_BUSY_POLL_US
+#define GD_EPAPER_BUSY_POLL_US 100 // minimum BUSY pin poll period near expected completion
+#endif
+#ifndef GD_EPAPER_BUSY_POLL_DIV
+#define GD_EPAPER_BUSY_POLL_DIV 64 // BUSY pin poll period is estimate/64, but not less than GD_EPAPER_BUSY_POLL_US
+#endif
+#ifndef GD_EPAPER_BUSY_EARLY_WAKE_DIV
+#define GD_EPAPER_BUSY_EARLY_WAKE_DIV 8 // wake up estimate/8 before expected completion and start polling
+#endif
+#ifndef GD_EPAPER_BUSY_EMA_DIV
+#define GD_EPAPER_BUSY_EMA_DIV 4 // duration estimate smoothing: estimate += (sample - estimate) / DIV
+#endif
+#ifndef GD_EPAPER_BUSY_TIMEOUT_US
+#define GD_EPAPER_BUSY_TIMEOUT_US 10000000 // BUSY edge wait timeout, polling continues after it
+#endif
+
     /*!
      * @brief Screen supported colors
      */
@@ -82,6 +154,52 @@ extern "C"
         GD_EPAPER_GPIO_HIGH = 0x1
     } gd_epaper_gpio_value;
 
+    /*!
+     * @brief Operations, which keeps BUSY pin low. Driver learns duration of each one
+     */
+    typedef enum
+    {
+        GD_EPAPER_BUSY_POWER_ON = 0,
+        GD_EPAPER_BUSY_TRANSFER,
+        GD_EPAPER_BUSY_REFRESH,
+        GD_EPAPER_BUSY_POWER_OFF,
+        GD_EPAPER_BUSY_REFRESH_FAST,
+        GD_EPAPER_BUSY_REFRESH_PARTIAL,
+        GD_EPAPER_BUSY_OP_COUNT
+    } gd_epaper_busy_op;
+
+    /*!
+     * @brief Refresh modes. Fast and partial modes are quicker, but leave ghosting, which only full refresh cleans
+     */
+    typedef enum
+    {
+        GD_EPAPER_REFRESH_FULL = 0, // OTP full waveform, display goes to deep sleep after update
+        GD_EPAPER_REFRESH_FAST,     // whole screen, fast waveform, controller is only powered off to retain RAM
+        GD_EPAPER_REFRESH_PARTIAL,  // changed pixels only, requires RAM retained since previous fast/partial update
+    } gd_epaper_refresh_mode;
+
+    /*!
+     * @brief Screen buffer rotation (clockwise) relative to native landscape orientation
+     */
+    typedef enum
+    {
+        GD_EPAPER_ROTATE_0 = 0,
+        GD_EPAPER_ROTATE_90,  // portrait, screen buffer is GD_EPAPER_HEIGHT x GD_EPAPER_WIDTH
+        GD_EPAPER_ROTATE_180,
+        GD_EPAPER_ROTATE_270, // portrait, screen buffer is GD_EPAPER_HEIGHT x GD_EPAPER_WIDTH
+    } gd_epaper_rotation;
+
+    /*!
+     * @brief Screen rectangle in pixels
+     */
+    typedef struct
+    {
+        uint16_t x;
+        uint16_t y;
+        uint16_t width;
+        uint16_t height;
+    } gd_epaper_region;
+
     /*!
      * @brief Bus communication function pointer which should be mapped to
      * the platform specific SPI write function
@@ -89,7 +207,7 @@ extern "C"
      *
      * @param[in] data          : Pointer to data buffer in which data to be written
      *                            is stored.
-     * @param[in] len           : Number of bytes of data to be written.
+     * @param[in] len           : Number of bits of data to be written.
      *
      * @retval 0                -> Success.
      * @retval Non zero value   -> Fail.
@@ -97,6 +215,22 @@ extern "C"
      */
     typedef int8_t (*gd_epaper_spi_write_fptr_t)(uint8_t *data, size_t len);
 
+    /*!
+     * @brief Bus communication function pointer, which sends same data block several times,
+     * e.g. using DMA with circular source buffer
+     * Optional, used only with hardware 4-wire SPI
+     * Data block is constant static block, so it stays valid and unchanged after return
+     *
+     * @param[in] data          : Pointer to data block
+     * @param[in] len           : Number of bits in data block
+     * @param[in] count         : How many times data block should be written
+     *
+     * @retval 0                -> Success.
+     * @retval Non zero value   -> Fail.
+     *
+     */
+    typedef int8_t (*gd_epaper_spi_write_repeat_fptr_t)(uint8_t *data, size_t len, size_t count);
+
     /*!
      * @brief GPIO write function pointer which should be mapped to
      * the platform specific GPIO write function
@@ -132,6 +266,19 @@ extern "C"
      */
     typedef void (*gd_epaper_delay_us_fptr_t)(uint32_t period);
 
+    /*!
+     * @brief BUSY edge wait function pointer which should be mapped to
+     * platform specific GPIO interrupt + RTOS wait (semaphore, notification, etc.)
+     * Optional, if not set driver polls BUSY pin
+     *
+     * @param[in] gpio          : BUSY GPIO
+     * @param[in] timeout_us    : Maximum wait time in microseconds
+     *
+     * @retval Time spent waiting in microseconds
+     *
+     */
+    typedef uint32_t (*gd_epaper_wait_busy_fptr_t)(uint8_t gpio, uint32_t timeout_us);
+
     /*!
      * @brief E-paper display device
      */
@@ -139,12 +286,16 @@ extern "C"
     {
         /* User defined hardware  SPI write function pointer, required if hardware SPI enabled */
         gd_epaper_spi_write_fptr_t spi_write_fptr;
+        /* User defined hardware SPI repeated block write function pointer, optional */
+        gd_epaper_spi_write_repeat_fptr_t spi_write_repeat_fptr;
         /* User defined hardware  GPIO read, required */
         gd_epaper_read_gpio_fptr_t gpio_read_fptr;
         /* User defined hardware GPIO write, required */
         gd_epaper_write_gpio_fptr_t gpio_write_fptr;
         /* User defined microseconds delay function, required */
         gd_epaper_delay_us_fptr_t delay_us_fptr;
+        /* User defined BUSY pin edge wait function, optional */
+        gd_epaper_wait_busy_fptr_t wait_busy_fptr;
         /* BUSY pin */
         int busy_pin;
         /* RESET pin */
@@ -159,8 +310,69 @@ extern "C"
         int cs_pin;
         /* Screen buffer ptr */
         uint8_t *screen_buffer;
+        /* Learned BUSY durations in microseconds, 0 - unknown yet. Can be preloaded from saved values */
+        uint32_t busy_estimate_us[GD_EPAPER_BUSY_OP_COUNT];
+        /* Screen buffer rotation, 180 is done by controller scan direction, 90/270 transposed while sending */
+        gd_epaper_rotation rotation;
+        /* Screen buffer mirroring (GD_EPAPER_MIRROR_X | GD_EPAPER_MIRROR_Y), done by controller scan direction */
+        uint8_t mirror;
+        /* Refresh mode used by init, transfer, refresh and update functions, fast/partial updates end with power off instead of deep sleep.
+         * Set by caller only, refresh scheduler selects mode per update and restores this one after it */
+        gd_epaper_refresh_mode refresh_mode;
     } gd_epaper_display_dev;
 
+    /*!
+     * @brief Function to calculate sleep before first BUSY check, short before expected completion.
+     * BUSY estimate helpers are shared by C and C++ drivers, so both learn durations same way
+     *
+     * @param[in] estimate         : Learned operation duration in us, 0 - unknown
+     *
+     * @retval Sleep in us
+     */
+    static inline uint32_t gd_epaper_busy_sleep_us(uint32_t estimate)
+    {
+        return estimate - estimate / GD_EPAPER_BUSY_EARLY_WAKE_DIV;
+    }
+    /*!
+     * @brief Function to calculate BUSY pin poll period for learned operation duration
+     *
+     * @param[in] estimate         : Learned operation duration in us, 0 - unknown
+     *
+     * @retval Poll period in us
+     */
+    static inline uint32_t gd_epaper_busy_poll_us(uint32_t estimate)
+    {
+        uint32_t poll = estimate / GD_EPAPER_BUSY_POLL_DIV;
+        return (poll < GD_EPAPER_BUSY_POLL_US) ? GD_EPAPER_BUSY_POLL_US : poll;
+    }
+    /*!
+     * @brief Function to update learned operation duration after wait
+     *
+     * @param[in] estimate         : Learned operation duration used for wait
+     * @param[in] elapsed          : Sleep, BUSY edge wait and poll delays before BUSY release was seen
+     * @param[in] edge_wait        : BUSY edge wait part of elapsed
+     * @param[in] polls            : Poll delays count
+     *
+     * @retval New duration estimate in us
+     */
+    static inline uint32_t gd_epaper_busy_estimate_us(uint32_t estimate, uint32_t elapsed, uint32_t edge_wait, uint32_t polls)
+    {
+        if (estimate > 0 && polls == 0 && edge_wait == 0)
+        {
+            return estimate / 2; // already done on wakeup, elapsed is only upper bound, so shrink estimate hard
+        }
+        if (polls > 0)
+        {
+            elapsed -= gd_epaper_busy_poll_us(estimate) / 2; // completion happened somewhere within last poll period
+        }
+        if (estimate == 0)
+        {
+            return elapsed;
+        }
+        // exponential moving average of operation duration
+        return estimate - estimate / GD_EPAPER_BUSY_EMA_DIV + elapsed / GD_EPAPER_BUSY_EMA_DIV;
+    }
+
 #ifdef __cplusplus
 }
 #endif
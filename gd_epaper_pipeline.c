@@ -0,0 +1,135 @@
+#include <string.h>
+
+#include "gd_epaper_pipeline.h"
+
+#define QUEUE_SIZE (GD_EPAPER_PIPELINE_MAX_BUFFERS + 1)
+
+/*!
+ * @brief Internal function to init empty queue
+ */
+static void queue_init(gd_epaper_frame_queue *queue)
+{
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+}
+/*!
+ * @brief Internal function to push index, producer side only. Queue can't overflow,
+ * as every buffer index is in one place at a time
+ */
+static void queue_push(gd_epaper_frame_queue *queue, uint8_t index)
+{
+    uint_least8_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+
+    queue->slots[head] = index;
+    // publish slot before moving head
+    atomic_store_explicit(&queue->head, (uint_least8_t)((head + 1) % QUEUE_SIZE), memory_order_release);
+}
+/*!
+ * @brief Internal function to pop index, consumer side only
+ *
+ * @retval Buffer index, -1 if queue is empty
+ */
+static int8_t queue_pop(gd_epaper_frame_queue *queue)
+{
+    uint_least8_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    uint8_t index;
+
+    if (tail == atomic_load_explicit(&queue->head, memory_order_acquire))
+    {
+        return -1;
+    }
+    index = queue->slots[tail];
+    // release slot after reading it
+    atomic_store_explicit(&queue->tail, (uint_least8_t)((tail + 1) % QUEUE_SIZE), memory_order_release);
+    return (int8_t)index;
+}
+
+int8_t gd_epaper_pipeline_init(gd_epaper_pipeline *pipeline, gd_epaper_display_dev *display,
+                               uint8_t *const *buffers, uint8_t count, uint8_t flags)
+{
+    if (pipeline == NULL || display == NULL || buffers == NULL)
+    {
+        return GD_EPAPER_E_NULL_PTR;
+    }
+    if (count < 2 || count > GD_EPAPER_PIPELINE_MAX_BUFFERS)
+    {
+        return GD_EPAPER_E_INVALID_ARG;
+    }
+    pipeline->display = display;
+    pipeline->buffer_count = count;
+    pipeline->flags = flags;
+    pipeline->back = -1;
+    pipeline->last = -1;
+    pipeline->dropped = 0;
+    queue_init(&pipeline->ready);
+    queue_init(&pipeline->free);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (buffers[i] == NULL)
+        {
+            return GD_EPAPER_E_NULL_PTR;
+        }
+        pipeline->buffers[i] = buffers[i];
+        queue_push(&pipeline->free, i);
+    }
+    return GD_EPAPER_OK;
+}
+
+uint8_t *gd_epaper_pipeline_acquire(gd_epaper_pipeline *pipeline)
+{
+    if (pipeline->back < 0)
+    {
+        pipeline->back = queue_pop(&pipeline->free);
+        if (pipeline->back < 0)
+        {
+            return NULL;
+        }
+        if ((pipeline->flags & GD_EPAPER_PIPELINE_PRESERVE) && pipeline->last >= 0 && pipeline->last != pipeline->back)
+        {
+            // driver task only reads buffers, so last frame can be copied while it is displayed
+            memcpy(pipeline->buffers[pipeline->back], pipeline->buffers[pipeline->last], GD_EPAPER_SCREEN_BUFFER_SIZE);
+        }
+    }
+    return pipeline->buffers[pipeline->back];
+}
+
+int8_t gd_epaper_pipeline_submit(gd_epaper_pipeline *pipeline)
+{
+    if (pipeline->back < 0)
+    {
+        return GD_EPAPER_E_INVALID_ARG;
+    }
+    queue_push(&pipeline->ready, (uint8_t)pipeline->back);
+    pipeline->last = pipeline->back;
+    pipeline->back = -1;
+    return GD_EPAPER_OK;
+}
+
+bool gd_epaper_pipeline_process(gd_epaper_pipeline *pipeline)
+{
+    int8_t front = queue_pop(&pipeline->ready);
+    int8_t newer;
+    uint8_t *buffer;
+
+    if (front < 0)
+    {
+        return false;
+    }
+    if (pipeline->flags & GD_EPAPER_PIPELINE_LATEST_WINS)
+    {
+        // release stale frames, keep newest one
+        while ((newer = queue_pop(&pipeline->ready)) >= 0)
+        {
+            queue_push(&pipeline->free, (uint8_t)front);
+            front = newer;
+            pipeline->dropped++;
+        }
+    }
+    // front buffer is lent to display only for this update, it goes back to render task after it
+    buffer = pipeline->display->screen_buffer;
+    pipeline->display->screen_buffer = pipeline->buffers[front];
+    gd_epaper_update_screen(pipeline->display);
+    pipeline->display->screen_buffer = buffer;
+    queue_push(&pipeline->free, (uint8_t)front);
+    return true;
+}
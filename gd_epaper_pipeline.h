@@ -0,0 +1,117 @@
+/*!
+ * Double buffered render/transfer pipeline for GooDisplay e-paper screens based on UC8179 ic driver
+ */
+
+#ifndef _GD_EPAPER_PIPELINE_H_
+#define _GD_EPAPER_PIPELINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+#include <atomic>
+typedef std::atomic<uint_least8_t> gd_epaper_atomic_index;
+#else
+#include <stdatomic.h>
+typedef atomic_uint_least8_t gd_epaper_atomic_index;
+#endif
+
+#include "./gd_epaper.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef GD_EPAPER_PIPELINE_MAX_BUFFERS
+#define GD_EPAPER_PIPELINE_MAX_BUFFERS 4
+#endif
+
+#define GD_EPAPER_PIPELINE_LATEST_WINS 0x01 // drop stale queued frames, show only newest one
+#define GD_EPAPER_PIPELINE_PRESERVE 0x02    // acquired buffer starts with copy of last submitted frame
+
+    /*!
+     * @brief Lock-free single-producer/single-consumer queue of buffer indices
+     */
+    typedef struct
+    {
+        /* Ring of buffer indices, one slot always stays empty */
+        uint8_t slots[GD_EPAPER_PIPELINE_MAX_BUFFERS + 1];
+        /* Next slot to write, changed only by producer side */
+        gd_epaper_atomic_index head;
+        /* Next slot to read, changed only by consumer side */
+        gd_epaper_atomic_index tail;
+    } gd_epaper_frame_queue;
+
+    /*!
+     * @brief Render/transfer pipeline. Render task owns acquire/submit, driver task owns process
+     */
+    typedef struct
+    {
+        /* Display device pointer, its screen buffer is switched to front buffer and restored while processing */
+        gd_epaper_display_dev *display;
+        /* GD_EPAPER_SCREEN_BUFFER_SIZE bytes frame buffers */
+        uint8_t *buffers[GD_EPAPER_PIPELINE_MAX_BUFFERS];
+        /* Frame buffers count */
+        uint8_t buffer_count;
+        /* GD_EPAPER_PIPELINE_LATEST_WINS | GD_EPAPER_PIPELINE_PRESERVE */
+        uint8_t flags;
+        /* Rendered frames, render task -> driver task */
+        gd_epaper_frame_queue ready;
+        /* Released buffers, driver task -> render task */
+        gd_epaper_frame_queue free;
+        /* Buffer acquired by render task, -1 if none */
+        int8_t back;
+        /* Last submitted buffer, -1 if none. Render task only */
+        int8_t last;
+        /* Frames dropped by latest wins coalescing */
+        uint32_t dropped;
+    } gd_epaper_pipeline;
+
+    /*!
+     * @brief Function to init pipeline, all buffers are free
+     *
+     * @param[out] pipeline        : Pipeline pointer
+     * @param[in] display          : Display device pointer
+     * @param[in] buffers          : Frame buffers, 3 recommended with GD_EPAPER_PIPELINE_LATEST_WINS
+     * @param[in] count            : Frame buffers count, 2 ... GD_EPAPER_PIPELINE_MAX_BUFFERS
+     * @param[in] flags            : GD_EPAPER_PIPELINE_LATEST_WINS | GD_EPAPER_PIPELINE_PRESERVE
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_NULL_PTR      -> Pipeline, display or buffers is NULL.
+     * @retval GD_EPAPER_E_INVALID_ARG   -> Wrong buffers count.
+     */
+    int8_t gd_epaper_pipeline_init(gd_epaper_pipeline *pipeline, gd_epaper_display_dev *display,
+                                   uint8_t *const *buffers, uint8_t count, uint8_t flags);
+    /*!
+     * @brief Render task function to get back buffer for drawing. Same buffer is returned until submit
+     *
+     * @param[in] pipeline         : Pipeline pointer
+     *
+     * @retval Back buffer, NULL if all buffers are queued or displayed
+     */
+    uint8_t *gd_epaper_pipeline_acquire(gd_epaper_pipeline *pipeline);
+    /*!
+     * @brief Render task function to queue back buffer for display
+     *
+     * @param[in] pipeline         : Pipeline pointer
+     *
+     * @retval GD_EPAPER_OK              -> Success.
+     * @retval GD_EPAPER_E_INVALID_ARG   -> No buffer acquired.
+     */
+    int8_t gd_epaper_pipeline_submit(gd_epaper_pipeline *pipeline);
+    /*!
+     * @brief Driver task function to display queued frame with gd_epaper_update_screen. Blocks for whole refresh.
+     * Display screen buffer points to front buffer only during update, previous pointer is restored after it
+     *
+     * @param[in] pipeline         : Pipeline pointer
+     *
+     * @retval true if frame was displayed, false if queue is empty
+     */
+    bool gd_epaper_pipeline_process(gd_epaper_pipeline *pipeline);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,277 @@
+#include <string.h>
+
+#include "gd_epaper_scheduler.h"
+
+#define TILE_PIXELS ((uint32_t)GD_EPAPER_SCHEDULER_TILE_SIZE * GD_EPAPER_SCHEDULER_TILE_SIZE)
+
+/*!
+ * @brief Internal function to count set bits
+ */
+static uint8_t popcount8(uint8_t value)
+{
+    value = (uint8_t)(value - ((value >> 1) & 0x55));
+    value = (uint8_t)((value & 0x33) + ((value >> 2) & 0x33));
+    return (uint8_t)((value + (value >> 4)) & 0x0F);
+}
+/*!
+ * @brief Internal function to count changed pixels per tile
+ *
+ * @param[in] scheduler        : Scheduler pointer
+ * @param[in] changed          : Changed region or NULL, used if there is no shadow
+ * @param[out] pixels          : Changed pixels per tile
+ * @param[out] bounds          : Bounding box of changes
+ *
+ * @retval true if something changed
+ */
+static bool measure_changes(const gd_epaper_scheduler *scheduler, const gd_epaper_region *changed,
+                            uint32_t *pixels, gd_epaper_region *bounds)
+{
+    const uint8_t *buffer = scheduler->display->screen_buffer;
+    uint16_t width = gd_epaper_get_width(scheduler->display);
+    uint16_t height = gd_epaper_get_height(scheduler->display);
+    uint16_t cols = (width + GD_EPAPER_SCHEDULER_TILE_SIZE - 1) / GD_EPAPER_SCHEDULER_TILE_SIZE;
+    uint32_t x0 = width;
+    uint32_t y0 = height;
+    uint32_t x1 = 0;
+    uint32_t y1 = 0;
+    uint8_t diff;
+
+    memset(pixels, 0, sizeof(uint32_t) * GD_EPAPER_SCHEDULER_TILES);
+    if (scheduler->shadow != NULL)
+    {
+        // exact difference with displayed frame
+        for (uint32_t y = 0; y < height; y++)
+        {
+            for (uint32_t byte = 0; byte < width / 8U; byte++)
+            {
+                diff = buffer[y * (width / 8U) + byte] ^ scheduler->shadow[y * (width / 8U) + byte];
+                if (diff == 0)
+                {
+                    continue;
+                }
+                pixels[(y / GD_EPAPER_SCHEDULER_TILE_SIZE) * cols + byte * 8 / GD_EPAPER_SCHEDULER_TILE_SIZE] += popcount8(diff);
+                x0 = (byte * 8 < x0) ? byte * 8 : x0;
+                x1 = (byte * 8 + 8 > x1) ? byte * 8 + 8 : x1;
+                y0 = (y < y0) ? y : y0;
+                y1 = (y + 1 > y1) ? y + 1 : y1;
+            }
+        }
+    }
+    else
+    {
+        // whole changed region is considered changed
+        x0 = (changed != NULL) ? changed->x : 0;
+        y0 = (changed != NULL) ? changed->y : 0;
+        x1 = (changed != NULL) ? (uint32_t)changed->x + changed->width : width;
+        y1 = (changed != NULL) ? (uint32_t)changed->y + changed->height : height;
+        x1 = (x1 > width) ? width : x1;
+        y1 = (y1 > height) ? height : y1;
+        for (uint32_t ty = y0 / GD_EPAPER_SCHEDULER_TILE_SIZE; ty * GD_EPAPER_SCHEDULER_TILE_SIZE < y1; ty++)
+        {
+            for (uint32_t tx = x0 / GD_EPAPER_SCHEDULER_TILE_SIZE; tx * GD_EPAPER_SCHEDULER_TILE_SIZE < x1; tx++)
+            {
+                uint32_t left = (tx * GD_EPAPER_SCHEDULER_TILE_SIZE > x0) ? tx * GD_EPAPER_SCHEDULER_TILE_SIZE : x0;
+                uint32_t top = (ty * GD_EPAPER_SCHEDULER_TILE_SIZE > y0) ? ty * GD_EPAPER_SCHEDULER_TILE_SIZE : y0;
+                uint32_t right = ((tx + 1) * GD_EPAPER_SCHEDULER_TILE_SIZE < x1) ? (tx + 1) * GD_EPAPER_SCHEDULER_TILE_SIZE : x1;
+                uint32_t bottom = ((ty + 1) * GD_EPAPER_SCHEDULER_TILE_SIZE < y1) ? (ty + 1) * GD_EPAPER_SCHEDULER_TILE_SIZE : y1;
+                pixels[ty * cols + tx] = (right - left) * (bottom - top);
+            }
+        }
+    }
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return false;
+    }
+    bounds->x = (uint16_t)x0;
+    bounds->y = (uint16_t)y0;
+    bounds->width = (uint16_t)(x1 - x0);
+    bounds->height = (uint16_t)(y1 - y0);
+    return true;
+}
+/*!
+ * @brief Internal function to calculate tile ghosting increase, any change costs at least 1
+ */
+static uint16_t ghost_increase(uint32_t pixels, uint16_t cost)
+{
+    uint32_t increase = (pixels * cost + TILE_PIXELS - 1) / TILE_PIXELS;
+    return (uint16_t)((pixels > 0 && increase == 0) ? 1 : increase);
+}
+/*!
+ * @brief Internal function to check all changed tiles stay within budget
+ */
+static bool within_budget(const gd_epaper_scheduler *scheduler, const uint32_t *pixels, uint16_t cost)
+{
+    for (size_t i = 0; i < GD_EPAPER_SCHEDULER_TILES; i++)
+    {
+        if (pixels[i] == 0)
+        {
+            continue;
+        }
+        if ((uint32_t)scheduler->ghost[i] + ghost_increase(pixels[i], cost) > scheduler->budget ||
+            (scheduler->max_updates > 0 && scheduler->updates[i] >= scheduler->max_updates))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+/*!
+ * @brief Internal function to select cheapest refresh mode keeping changed tiles within budget
+ */
+static gd_epaper_refresh_mode select_mode(const gd_epaper_scheduler *scheduler, const uint32_t *pixels)
+{
+    const gd_epaper_display_dev *display = scheduler->display;
+    gd_epaper_refresh_mode candidates[] = {GD_EPAPER_REFRESH_PARTIAL, GD_EPAPER_REFRESH_FAST};
+    uint16_t cost;
+
+    // partial is normally cheapest, but learned refresh durations decide
+    if (display->busy_estimate_us[GD_EPAPER_BUSY_REFRESH_FAST] > 0 &&
+        display->busy_estimate_us[GD_EPAPER_BUSY_REFRESH_PARTIAL] > display->busy_estimate_us[GD_EPAPER_BUSY_REFRESH_FAST])
+    {
+        candidates[0] = GD_EPAPER_REFRESH_FAST;
+        candidates[1] = GD_EPAPER_REFRESH_PARTIAL;
+    }
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++)
+    {
+        if (candidates[i] == GD_EPAPER_REFRESH_PARTIAL && !scheduler->ram_valid)
+        {
+            continue; // no displayed frame in controller RAM to compare with
+        }
+        cost = (candidates[i] == GD_EPAPER_REFRESH_FAST) ? scheduler->fast_cost : scheduler->partial_cost;
+        if (within_budget(scheduler, pixels, cost))
+        {
+            return candidates[i];
+        }
+    }
+    return GD_EPAPER_REFRESH_FULL;
+}
+/*!
+ * @brief Internal function to forget ghosting after full refresh
+ */
+static void reset_tiles(gd_epaper_scheduler *scheduler)
+{
+    memset(scheduler->ghost, 0, sizeof(scheduler->ghost));
+    memset(scheduler->updates, 0, sizeof(scheduler->updates));
+    scheduler->ram_valid = false; // display is in deep sleep
+}
+
+void gd_epaper_scheduler_init(gd_epaper_scheduler *scheduler, gd_epaper_display_dev *display, uint8_t *shadow)
+{
+    scheduler->display = display;
+    scheduler->shadow = shadow;
+    scheduler->budget = GD_EPAPER_SCHEDULER_BUDGET;
+    scheduler->max_updates = 0;
+    scheduler->fast_cost = GD_EPAPER_SCHEDULER_FAST_COST;
+    scheduler->partial_cost = GD_EPAPER_SCHEDULER_PARTIAL_COST;
+    scheduler->state_unknown = true; // first update is full, whatever shadow contains
+    reset_tiles(scheduler);
+}
+
+int8_t gd_epaper_scheduler_update(gd_epaper_scheduler *scheduler, const gd_epaper_region *changed, gd_epaper_refresh_mode *mode)
+{
+    gd_epaper_display_dev *display;
+    uint32_t pixels[GD_EPAPER_SCHEDULER_TILES];
+    gd_epaper_region bounds;
+    gd_epaper_refresh_mode selected;
+    gd_epaper_refresh_mode previous;
+    uint16_t cost;
+    int8_t rslt = GD_EPAPER_OK;
+
+    if (scheduler == NULL)
+    {
+        return GD_EPAPER_E_NULL_PTR;
+    }
+    display = scheduler->display;
+    if (scheduler->state_unknown)
+    {
+        // shadow doesn't describe panel yet, so diff is meaningless
+        memset(pixels, 0, sizeof(pixels));
+        selected = GD_EPAPER_REFRESH_FULL;
+    }
+    else
+    {
+        if (!measure_changes(scheduler, changed, pixels, &bounds))
+        {
+            return GD_EPAPER_OK;
+        }
+        selected = select_mode(scheduler, pixels);
+    }
+
+    // refresh mode is caller's setting, selected one is used only for this update
+    previous = display->refresh_mode;
+    display->refresh_mode = selected;
+    if (selected == GD_EPAPER_REFRESH_PARTIAL)
+    {
+        rslt = gd_epaper_update_region(display, &bounds);
+    }
+    else
+    {
+        gd_epaper_update_screen(display);
+    }
+    display->refresh_mode = previous;
+    if (rslt != GD_EPAPER_OK)
+    {
+        return rslt;
+    }
+
+    if (selected == GD_EPAPER_REFRESH_FULL)
+    {
+        reset_tiles(scheduler);
+        scheduler->state_unknown = false;
+    }
+    else
+    {
+        cost = (selected == GD_EPAPER_REFRESH_FAST) ? scheduler->fast_cost : scheduler->partial_cost;
+        for (size_t i = 0; i < GD_EPAPER_SCHEDULER_TILES; i++)
+        {
+            if (pixels[i] > 0)
+            {
+                scheduler->ghost[i] += ghost_increase(pixels[i], cost);
+                scheduler->updates[i]++;
+            }
+        }
+        scheduler->ram_valid = true;
+    }
+    if (scheduler->shadow != NULL)
+    {
+        memcpy(scheduler->shadow, display->screen_buffer, GD_EPAPER_SCREEN_BUFFER_SIZE);
+    }
+    if (mode != NULL)
+    {
+        *mode = selected;
+    }
+    return GD_EPAPER_OK;
+}
+
+bool gd_epaper_scheduler_idle(gd_epaper_scheduler *scheduler)
+{
+    if (scheduler->state_unknown)
+    {
+        return false; // nothing displayed yet, shadow was never shown
+    }
+    for (size_t i = 0; i < GD_EPAPER_SCHEDULER_TILES; i++)
+    {
+        if (scheduler->ghost[i] > 0)
+        {
+            // cleaning full refresh of displayed frame, not of screen buffer drawn since then
+            uint8_t *buffer = scheduler->display->screen_buffer;
+            gd_epaper_refresh_mode previous = scheduler->display->refresh_mode;
+            if (scheduler->shadow != NULL)
+            {
+                scheduler->display->screen_buffer = scheduler->shadow;
+            }
+            scheduler->display->refresh_mode = GD_EPAPER_REFRESH_FULL;
+            gd_epaper_update_screen(scheduler->display);
+            scheduler->display->screen_buffer = buffer;
+            scheduler->display->refresh_mode = previous;
+            reset_tiles(scheduler);
+            return true;
+        }
+    }
+    if (scheduler->ram_valid)
+    {
+        gd_epaper_send_sleep(scheduler->display);
+        scheduler->ram_valid = false;
+    }
+    return false;
+}
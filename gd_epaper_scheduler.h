@@ -0,0 +1,97 @@
+/*!
+ * Ghosting-aware refresh scheduler for GooDisplay e-paper screens based on UC8179 ic driver
+ */
+
+#ifndef _GD_EPAPER_SCHEDULER_H_
+#define _GD_EPAPER_SCHEDULER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "./gd_epaper.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef GD_EPAPER_SCHEDULER_TILE_SIZE
+#define GD_EPAPER_SCHEDULER_TILE_SIZE 80 // ghosting tracking tile size in pixels, multiple of 8
+#endif
+#ifndef GD_EPAPER_SCHEDULER_BUDGET
+#define GD_EPAPER_SCHEDULER_BUDGET 256 // default ghosting budget per tile
+#endif
+#ifndef GD_EPAPER_SCHEDULER_FAST_COST
+#define GD_EPAPER_SCHEDULER_FAST_COST 16 // default ghosting of fully changed tile by fast refresh
+#endif
+#ifndef GD_EPAPER_SCHEDULER_PARTIAL_COST
+#define GD_EPAPER_SCHEDULER_PARTIAL_COST 32 // default ghosting of fully changed tile by partial refresh
+#endif
+
+#define GD_EPAPER_SCHEDULER_TILES (((GD_EPAPER_WIDTH + GD_EPAPER_SCHEDULER_TILE_SIZE - 1) / GD_EPAPER_SCHEDULER_TILE_SIZE) * \
+                                   ((GD_EPAPER_HEIGHT + GD_EPAPER_SCHEDULER_TILE_SIZE - 1) / GD_EPAPER_SCHEDULER_TILE_SIZE))
+
+    /*!
+     * @brief Refresh scheduler, tracks ghosting per screen tile and selects cheapest refresh mode within budget
+     */
+    typedef struct
+    {
+        /* Display device pointer, its screen buffer is displayed */
+        gd_epaper_display_dev *display;
+        /* Optional copy of displayed frame to measure changed pixels exactly, NULL - changed region is used */
+        uint8_t *shadow;
+        /* Accumulated ghosting per tile since last full refresh */
+        uint16_t ghost[GD_EPAPER_SCHEDULER_TILES];
+        /* Fast/partial updates per tile since last full refresh */
+        uint16_t updates[GD_EPAPER_SCHEDULER_TILES];
+        /* Maximum ghosting per tile, full refresh is done when it would be exceeded */
+        uint16_t budget;
+        /* Maximum fast/partial updates per tile, 0 - unlimited */
+        uint16_t max_updates;
+        /* Ghosting of fully changed tile by fast refresh */
+        uint16_t fast_cost;
+        /* Ghosting of fully changed tile by partial refresh */
+        uint16_t partial_cost;
+        /* Controller RAM holds displayed frame, partial refresh is possible */
+        bool ram_valid;
+        /* Panel content is unknown until first update, which is always full */
+        bool state_unknown;
+    } gd_epaper_scheduler;
+
+    /*!
+     * @brief Function to init scheduler with default budget and costs. First update is always full
+     *
+     * @param[out] scheduler       : Scheduler pointer
+     * @param[in] display          : Display device pointer
+     * @param[in] shadow           : GD_EPAPER_SCREEN_BUFFER_SIZE bytes buffer or NULL
+     */
+    void gd_epaper_scheduler_init(gd_epaper_scheduler *scheduler, gd_epaper_display_dev *display, uint8_t *shadow);
+    /*!
+     * @brief Function to display screen buffer with cheapest refresh mode, which keeps ghosting within budget.
+     * Display refresh_mode is used only for this update and restored after it
+     *
+     * @param[in] scheduler        : Scheduler pointer
+     * @param[in] changed          : Changed screen buffer region, NULL - whole screen. Ignored if shadow is set
+     * @param[out] mode            : Used refresh mode, may be NULL. Not written if nothing changed
+     *
+     * @retval GD_EPAPER_OK              -> Success, or nothing to update.
+     * @retval GD_EPAPER_E_NULL_PTR      -> Scheduler is NULL.
+     * @retval Other error               -> See gd_epaper_update_region.
+     */
+    int8_t gd_epaper_scheduler_update(gd_epaper_scheduler *scheduler, const gd_epaper_region *changed, gd_epaper_refresh_mode *mode);
+    /*!
+     * @brief Function to call when device is idle. Cleans ghosting with full refresh of displayed frame
+     * (shadow, or screen buffer if there is no shadow) if there is any, otherwise sends powered off display to deep sleep.
+     * Does nothing before first update
+     *
+     * @param[in] scheduler        : Scheduler pointer
+     *
+     * @retval true if full refresh was done
+     */
+    bool gd_epaper_scheduler_idle(gd_epaper_scheduler *scheduler);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
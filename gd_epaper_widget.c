@@ -0,0 +1,502 @@
+#include <string.h>
+
+#include "gd_epaper_widget.h"
+
+/*!
+ * @brief Internal function to intersect regions
+ *
+ * @retval true if intersection is not empty
+ */
+static bool region_intersect(const gd_epaper_region *a, const gd_epaper_region *b, gd_epaper_region *out)
+{
+    int32_t x0 = (a->x > b->x) ? a->x : b->x;
+    int32_t y0 = (a->y > b->y) ? a->y : b->y;
+    int32_t x1 = ((int32_t)a->x + a->width < (int32_t)b->x + b->width) ? (int32_t)a->x + a->width : (int32_t)b->x + b->width;
+    int32_t y1 = ((int32_t)a->y + a->height < (int32_t)b->y + b->height) ? (int32_t)a->y + a->height : (int32_t)b->y + b->height;
+
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return false;
+    }
+    out->x = (uint16_t)x0;
+    out->y = (uint16_t)y0;
+    out->width = (uint16_t)(x1 - x0);
+    out->height = (uint16_t)(y1 - y0);
+    return true;
+}
+/*!
+ * @brief Internal function to extend region a with region b
+ */
+static void region_union(gd_epaper_region *a, const gd_epaper_region *b)
+{
+    int32_t x0 = (a->x < b->x) ? a->x : b->x;
+    int32_t y0 = (a->y < b->y) ? a->y : b->y;
+    int32_t x1 = ((int32_t)a->x + a->width > (int32_t)b->x + b->width) ? (int32_t)a->x + a->width : (int32_t)b->x + b->width;
+    int32_t y1 = ((int32_t)a->y + a->height > (int32_t)b->y + b->height) ? (int32_t)a->y + a->height : (int32_t)b->y + b->height;
+
+    a->x = (uint16_t)x0;
+    a->y = (uint16_t)y0;
+    a->width = (uint16_t)(x1 - x0);
+    a->height = (uint16_t)(y1 - y0);
+}
+/*!
+ * @brief Internal function to check regions overlap or are closer than GD_EPAPER_WIDGET_MERGE_GAP
+ */
+static bool region_near(const gd_epaper_region *a, const gd_epaper_region *b)
+{
+    return (int32_t)a->x <= (int32_t)b->x + b->width + GD_EPAPER_WIDGET_MERGE_GAP &&
+           (int32_t)b->x <= (int32_t)a->x + a->width + GD_EPAPER_WIDGET_MERGE_GAP &&
+           (int32_t)a->y <= (int32_t)b->y + b->height + GD_EPAPER_WIDGET_MERGE_GAP &&
+           (int32_t)b->y <= (int32_t)a->y + a->height + GD_EPAPER_WIDGET_MERGE_GAP;
+}
+/*!
+ * @brief Internal function to calculate region area
+ */
+static uint32_t region_area(const gd_epaper_region *region)
+{
+    return (uint32_t)region->width * region->height;
+}
+/*!
+ * @brief Internal function to scale value from min..max to 0..range
+ */
+static int32_t scale_value(int32_t value, int32_t min, int32_t max, int32_t range)
+{
+    if (max <= min)
+    {
+        return 0;
+    }
+    if (value < min)
+    {
+        value = min;
+    }
+    if (value > max)
+    {
+        value = max;
+    }
+    return (int32_t)(((int64_t)(value - min) * range) / (max - min));
+}
+
+void gd_epaper_canvas_init(gd_epaper_canvas *canvas, gd_epaper_display_dev *display)
+{
+    canvas->buffer = display->screen_buffer;
+    canvas->width = gd_epaper_get_width(display);
+    canvas->height = gd_epaper_get_height(display);
+    canvas->clip.x = 0;
+    canvas->clip.y = 0;
+    canvas->clip.width = canvas->width;
+    canvas->clip.height = canvas->height;
+}
+
+void gd_epaper_draw_pixel(gd_epaper_canvas *canvas, int16_t x, int16_t y, gd_epaper_color color)
+{
+    uint8_t *byte;
+
+    if (x < canvas->clip.x || y < canvas->clip.y ||
+        x >= canvas->clip.x + canvas->clip.width || y >= canvas->clip.y + canvas->clip.height)
+    {
+        // Don't write outside the clip
+        return;
+    }
+    byte = &canvas->buffer[(size_t)y * (canvas->width / 8) + x / 8];
+    if (color == GD_EPAPER_BLACK)
+    {
+        *byte |= (uint8_t)(0x80 >> (x % 8));
+    }
+    else
+    {
+        *byte &= (uint8_t)~(0x80 >> (x % 8));
+    }
+}
+
+void gd_epaper_fill_rect(gd_epaper_canvas *canvas, const gd_epaper_region *rect, gd_epaper_color color)
+{
+    gd_epaper_region area;
+    uint8_t *row;
+    uint16_t first;
+    uint16_t last;
+    uint8_t first_mask;
+    uint8_t last_mask;
+
+    if (!region_intersect(rect, &canvas->clip, &area))
+    {
+        return;
+    }
+    first = area.x / 8;
+    last = (area.x + area.width - 1) / 8;
+    first_mask = (uint8_t)(0xFF >> (area.x % 8));
+    last_mask = (uint8_t)(0xFF << (7 - (area.x + area.width - 1) % 8));
+    if (first == last)
+    {
+        first_mask &= last_mask;
+    }
+    for (uint16_t y = area.y; y < area.y + area.height; y++)
+    {
+        row = &canvas->buffer[(size_t)y * (canvas->width / 8)];
+        // partial edge bytes by mask, whole bytes at once
+        row[first] = (uint8_t)((row[first] & ~first_mask) | ((uint8_t)color & first_mask));
+        if (first != last)
+        {
+            memset(&row[first + 1], (uint8_t)color, last - first - 1);
+            row[last] = (uint8_t)((row[last] & ~last_mask) | ((uint8_t)color & last_mask));
+        }
+    }
+}
+
+void gd_epaper_draw_line(gd_epaper_canvas *canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, gd_epaper_color color)
+{
+    int32_t delta_x = (x1 > x0) ? x1 - x0 : x0 - x1;
+    int32_t delta_y = (y1 > y0) ? y1 - y0 : y0 - y1;
+    int32_t sign_x = (x0 < x1) ? 1 : -1;
+    int32_t sign_y = (y0 < y1) ? 1 : -1;
+    int32_t error = delta_x - delta_y;
+    int32_t error2;
+
+    gd_epaper_draw_pixel(canvas, x1, y1, color);
+    while (x0 != x1 || y0 != y1)
+    {
+        gd_epaper_draw_pixel(canvas, x0, y0, color);
+        error2 = error * 2;
+        if (error2 > -delta_y)
+        {
+            error -= delta_y;
+            x0 += sign_x;
+        }
+        if (error2 < delta_x)
+        {
+            error += delta_x;
+            y0 += sign_y;
+        }
+    }
+}
+
+void gd_epaper_draw_bitmap(gd_epaper_canvas *canvas, int16_t x, int16_t y, uint16_t width, uint16_t height,
+                           const uint8_t *bitmap, gd_epaper_color color)
+{
+    size_t stride = (width + 7) / 8;
+
+    for (uint16_t row = 0; row < height; row++)
+    {
+        for (uint16_t col = 0; col < width; col++)
+        {
+            if (bitmap[row * stride + col / 8] & (0x80 >> (col % 8)))
+            {
+                gd_epaper_draw_pixel(canvas, (int16_t)(x + col), (int16_t)(y + row), color);
+            }
+        }
+    }
+}
+
+void gd_epaper_draw_text(gd_epaper_canvas *canvas, int16_t x, int16_t y, const gd_epaper_font *font,
+                         const char *text, gd_epaper_color color)
+{
+    size_t glyph_size;
+
+    if (font == NULL || text == NULL)
+    {
+        return;
+    }
+    glyph_size = (size_t)((font->width + 7) / 8) * font->height;
+    for (; *text != '\0'; text++, x += font->width)
+    {
+        if (*text < font->first || *text > font->last)
+        {
+            continue;
+        }
+        gd_epaper_draw_bitmap(canvas, x, y, font->width, font->height,
+                              &font->glyphs[(size_t)(*text - font->first) * glyph_size], color);
+    }
+}
+
+void gd_epaper_widget_render_text(const gd_epaper_widget *widget, gd_epaper_canvas *canvas)
+{
+    gd_epaper_draw_text(canvas, (int16_t)widget->bounds.x, (int16_t)widget->bounds.y, widget->font, widget->text, widget->color);
+}
+
+void gd_epaper_widget_render_number(const gd_epaper_widget *widget, gd_epaper_canvas *canvas)
+{
+    char text[12]; // "-2147483648"
+    char *pos = &text[sizeof(text) - 1];
+    uint32_t value = (widget->value < 0) ? 0U - (uint32_t)widget->value : (uint32_t)widget->value;
+
+    *pos = '\0';
+    do
+    {
+        *--pos = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    if (widget->value < 0)
+    {
+        *--pos = '-';
+    }
+    gd_epaper_draw_text(canvas, (int16_t)widget->bounds.x, (int16_t)widget->bounds.y, widget->font, pos, widget->color);
+}
+
+void gd_epaper_widget_render_gauge(const gd_epaper_widget *widget, gd_epaper_canvas *canvas)
+{
+    const gd_epaper_region *b = &widget->bounds;
+    gd_epaper_region bar;
+    int16_t x1 = (int16_t)(b->x + b->width - 1);
+    int16_t y1 = (int16_t)(b->y + b->height - 1);
+
+    if (b->width < 5 || b->height < 5)
+    {
+        return;
+    }
+    // frame
+    gd_epaper_draw_line(canvas, (int16_t)b->x, (int16_t)b->y, x1, (int16_t)b->y, widget->color);
+    gd_epaper_draw_line(canvas, (int16_t)b->x, y1, x1, y1, widget->color);
+    gd_epaper_draw_line(canvas, (int16_t)b->x, (int16_t)b->y, (int16_t)b->x, y1, widget->color);
+    gd_epaper_draw_line(canvas, x1, (int16_t)b->y, x1, y1, widget->color);
+    // bar with 1 pixel gap to frame
+    bar.x = b->x + 2;
+    bar.y = b->y + 2;
+    bar.width = (uint16_t)scale_value(widget->value, widget->min, widget->max, b->width - 4);
+    bar.height = b->height - 4;
+    if (bar.width > 0)
+    {
+        gd_epaper_fill_rect(canvas, &bar, widget->color);
+    }
+}
+
+void gd_epaper_widget_render_icon(const gd_epaper_widget *widget, gd_epaper_canvas *canvas)
+{
+    if (widget->bitmap == NULL)
+    {
+        return;
+    }
+    gd_epaper_draw_bitmap(canvas, (int16_t)widget->bounds.x, (int16_t)widget->bounds.y,
+                          widget->bounds.width, widget->bounds.height, widget->bitmap, widget->color);
+}
+
+void gd_epaper_widget_render_bar_chart(const gd_epaper_widget *widget, gd_epaper_canvas *canvas)
+{
+    const gd_epaper_region *b = &widget->bounds;
+    gd_epaper_region bar;
+    uint16_t pitch;
+
+    if (widget->series == NULL || widget->series_count == 0)
+    {
+        return;
+    }
+    pitch = (uint16_t)(b->width / widget->series_count);
+    if (pitch == 0)
+    {
+        return;
+    }
+    bar.width = (pitch > 1) ? pitch - 1 : 1; // 1 pixel gap between bars
+    for (size_t i = 0; i < widget->series_count; i++)
+    {
+        bar.height = (uint16_t)scale_value(widget->series[i], widget->min, widget->max, b->height);
+        bar.x = (uint16_t)(b->x + i * pitch);
+        bar.y = b->y + b->height - bar.height;
+        if (bar.height > 0)
+        {
+            gd_epaper_fill_rect(canvas, &bar, widget->color);
+        }
+    }
+}
+
+void gd_epaper_widget_render_sparkline(const gd_epaper_widget *widget, gd_epaper_canvas *canvas)
+{
+    const gd_epaper_region *b = &widget->bounds;
+    int16_t x0;
+    int16_t y0;
+    int16_t x1;
+    int16_t y1;
+
+    if (widget->series == NULL || widget->series_count < 2 || b->width == 0 || b->height == 0)
+    {
+        return;
+    }
+    x0 = (int16_t)b->x;
+    y0 = (int16_t)(b->y + b->height - 1 - scale_value(widget->series[0], widget->min, widget->max, b->height - 1));
+    for (size_t i = 1; i < widget->series_count; i++)
+    {
+        x1 = (int16_t)(b->x + (i * (b->width - 1)) / (widget->series_count - 1));
+        y1 = (int16_t)(b->y + b->height - 1 - scale_value(widget->series[i], widget->min, widget->max, b->height - 1));
+        gd_epaper_draw_line(canvas, x0, y0, x1, y1, widget->color);
+        x0 = x1;
+        y0 = y1;
+    }
+}
+
+/*!
+ * @brief Internal function to invalidate widget and all its children
+ */
+static void invalidate_tree(gd_epaper_widget_screen *screen, gd_epaper_widget *widget)
+{
+    for (; widget != NULL; widget = widget->next)
+    {
+        gd_epaper_widget_invalidate(screen, widget);
+        invalidate_tree(screen, widget->child);
+    }
+}
+/*!
+ * @brief Internal function to add dirty region, merging it with near ones.
+ * If all slots are used, it is merged with region growing least
+ */
+static void add_dirty(gd_epaper_widget_screen *screen, const gd_epaper_region *region)
+{
+    gd_epaper_region merged = *region;
+    gd_epaper_region grown;
+    uint32_t growth;
+    uint32_t best_growth = UINT32_MAX;
+    uint8_t best = 0;
+    uint8_t i = 0;
+
+    while (i < screen->dirty_count)
+    {
+        if (region_near(&screen->dirty[i], &merged))
+        {
+            // grown region may reach already checked ones, so start over
+            region_union(&merged, &screen->dirty[i]);
+            screen->dirty[i] = screen->dirty[--screen->dirty_count];
+            i = 0;
+        }
+        else
+        {
+            i++;
+        }
+    }
+    if (screen->dirty_count < GD_EPAPER_WIDGET_MAX_DIRTY)
+    {
+        screen->dirty[screen->dirty_count++] = merged;
+        return;
+    }
+    for (i = 0; i < screen->dirty_count; i++)
+    {
+        grown = screen->dirty[i];
+        region_union(&grown, &merged);
+        growth = region_area(&grown) - region_area(&screen->dirty[i]);
+        if (growth < best_growth)
+        {
+            best_growth = growth;
+            best = i;
+        }
+    }
+    region_union(&merged, &screen->dirty[best]);
+    screen->dirty[best] = screen->dirty[--screen->dirty_count];
+    add_dirty(screen, &merged);
+}
+/*!
+ * @brief Internal function to render widgets intersecting canvas clip in tree order
+ */
+static void render_tree(gd_epaper_widget *widget, gd_epaper_canvas *canvas)
+{
+    gd_epaper_region area;
+
+    for (; widget != NULL; widget = widget->next)
+    {
+        if (region_intersect(&widget->bounds, &canvas->clip, &area))
+        {
+            gd_epaper_fill_rect(canvas, &widget->bounds, widget->background);
+            if (widget->render_fptr != NULL)
+            {
+                widget->render_fptr(widget, canvas);
+            }
+        }
+        render_tree(widget->child, canvas);
+    }
+}
+
+void gd_epaper_widget_screen_init(gd_epaper_widget_screen *screen, gd_epaper_display_dev *display, gd_epaper_widget *root)
+{
+    screen->display = display;
+    screen->root = root;
+    screen->dirty_count = 0;
+    invalidate_tree(screen, root);
+}
+
+void gd_epaper_widget_add(gd_epaper_widget_screen *screen, gd_epaper_widget *parent, gd_epaper_widget *widget)
+{
+    gd_epaper_widget **link = (parent != NULL) ? &parent->child : &screen->root;
+
+    while (*link != NULL)
+    {
+        link = &(*link)->next;
+    }
+    *link = widget;
+    widget->next = NULL;
+    invalidate_tree(screen, widget);
+}
+
+void gd_epaper_widget_invalidate(gd_epaper_widget_screen *screen, gd_epaper_widget *widget)
+{
+    if (widget->bounds.width == 0 || widget->bounds.height == 0)
+    {
+        return;
+    }
+    add_dirty(screen, &widget->bounds);
+}
+
+void gd_epaper_widget_set_value(gd_epaper_widget_screen *screen, gd_epaper_widget *widget, int32_t value)
+{
+    if (widget->value != value)
+    {
+        widget->value = value;
+        gd_epaper_widget_invalidate(screen, widget);
+    }
+}
+
+void gd_epaper_widget_set_text(gd_epaper_widget_screen *screen, gd_epaper_widget *widget, const char *text)
+{
+    // same pointer may be buffer with new content, so only different pointers are compared
+    bool same = widget->text != text && widget->text != NULL && text != NULL && strcmp(widget->text, text) == 0;
+
+    widget->text = text;
+    if (!same)
+    {
+        gd_epaper_widget_invalidate(screen, widget);
+    }
+}
+
+void gd_epaper_widget_set_series(gd_epaper_widget_screen *screen, gd_epaper_widget *widget, const int32_t *series, size_t count)
+{
+    widget->series = series;
+    widget->series_count = count;
+    gd_epaper_widget_invalidate(screen, widget);
+}
+
+uint8_t gd_epaper_widget_render(gd_epaper_widget_screen *screen, gd_epaper_region *regions)
+{
+    gd_epaper_canvas canvas;
+    gd_epaper_region area;
+    uint8_t count = 0;
+
+    gd_epaper_canvas_init(&canvas, screen->display);
+    area = canvas.clip;
+    for (uint8_t i = 0; i < screen->dirty_count; i++)
+    {
+        if (!region_intersect(&screen->dirty[i], &area, &canvas.clip))
+        {
+            continue;
+        }
+        // everything overlapping dirty region is redrawn in tree order, outside pixels are kept
+        render_tree(screen->root, &canvas);
+        if (regions != NULL)
+        {
+            regions[count] = canvas.clip;
+        }
+        count++;
+    }
+    screen->dirty_count = 0;
+    return count;
+}
+
+int8_t gd_epaper_widget_update(gd_epaper_widget_screen *screen)
+{
+    gd_epaper_region regions[GD_EPAPER_WIDGET_MAX_DIRTY];
+    uint8_t count = gd_epaper_widget_render(screen, regions);
+
+    if (count == 0)
+    {
+        return GD_EPAPER_OK;
+    }
+    // every refresh costs seconds, so all regions go in one update. Controller RAM outside sent window
+    // isn't reliable after reset, so window is their union
+    for (uint8_t i = 1; i < count; i++)
+    {
+        region_union(&regions[0], &regions[i]);
+    }
+    return gd_epaper_update_region(screen->display, &regions[0]);
+}
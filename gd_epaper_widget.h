@@ -0,0 +1,233 @@
+/*!
+ * Retained mode widgets for GooDisplay e-paper screens based on UC8179 ic driver
+ */
+
+#ifndef _GD_EPAPER_WIDGET_H_
+#define _GD_EPAPER_WIDGET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "./gd_epaper.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef GD_EPAPER_WIDGET_MAX_DIRTY
+#define GD_EPAPER_WIDGET_MAX_DIRTY 8 // separately rendered and refreshed regions, more are merged
+#endif
+#ifndef GD_EPAPER_WIDGET_MERGE_GAP
+#define GD_EPAPER_WIDGET_MERGE_GAP 8 // invalidated regions closer than this (pixels) are merged
+#endif
+
+    /*!
+     * @brief Bitmap font, glyphs are height rows of (width + 7) / 8 bytes, MSB first
+     */
+    typedef struct
+    {
+        /* Glyph width in pixels */
+        uint8_t width;
+        /* Glyph height in pixels */
+        uint8_t height;
+        /* First glyph character */
+        char first;
+        /* Last glyph character */
+        char last;
+        /* Glyphs data */
+        const uint8_t *glyphs;
+    } gd_epaper_font;
+
+    /*!
+     * @brief Drawing target, screen buffer with clip rectangle
+     */
+    typedef struct
+    {
+        /* Screen buffer ptr */
+        uint8_t *buffer;
+        /* Screen buffer width, see gd_epaper_get_width */
+        uint16_t width;
+        /* Screen buffer height, see gd_epaper_get_height */
+        uint16_t height;
+        /* Only pixels inside clip are changed */
+        gd_epaper_region clip;
+    } gd_epaper_canvas;
+
+    typedef struct gd_epaper_widget gd_epaper_widget;
+
+    /*!
+     * @brief Widget render function pointer. Widget bounds are already filled with background
+     *
+     * @param[in] widget           : Widget to render
+     * @param[in] canvas           : Drawing target
+     */
+    typedef void (*gd_epaper_widget_render_fptr_t)(const gd_epaper_widget *widget, gd_epaper_canvas *canvas);
+
+    /*!
+     * @brief Widget, node of retained widget tree
+     */
+    struct gd_epaper_widget
+    {
+        /* Widget bounds in screen buffer coordinates */
+        gd_epaper_region bounds;
+        /* Render function, built-in gd_epaper_widget_render_* or user defined */
+        gd_epaper_widget_render_fptr_t render_fptr;
+        /* Foreground color */
+        gd_epaper_color color;
+        /* Background color, bounds are filled with it before render */
+        gd_epaper_color background;
+        /* Value of number, gauge */
+        int32_t value;
+        /* Value range of gauge, bar chart, sparkline */
+        int32_t min;
+        int32_t max;
+        /* Text of text field */
+        const char *text;
+        /* Font of text field, number */
+        const gd_epaper_font *font;
+        /* Icon bitmap, bounds size, MSB first rows */
+        const uint8_t *bitmap;
+        /* Values of bar chart, sparkline */
+        const int32_t *series;
+        size_t series_count;
+        /* User data for custom render functions */
+        void *user_data;
+        /* Next sibling */
+        gd_epaper_widget *next;
+        /* First child, rendered after parent */
+        gd_epaper_widget *child;
+    };
+
+    /*!
+     * @brief Widget tree bound to display
+     */
+    typedef struct
+    {
+        /* Display device pointer, widgets are rendered to its screen buffer */
+        gd_epaper_display_dev *display;
+        /* First top level widget */
+        gd_epaper_widget *root;
+        /* Invalidated regions, overlapping or close ones are merged */
+        gd_epaper_region dirty[GD_EPAPER_WIDGET_MAX_DIRTY];
+        /* Invalidated regions count */
+        uint8_t dirty_count;
+    } gd_epaper_widget_screen;
+
+    /*!
+     * @brief Function to init canvas with display screen buffer, clip is whole screen
+     *
+     * @param[out] canvas          : Canvas pointer
+     * @param[in] display          : Display device pointer
+     */
+    void gd_epaper_canvas_init(gd_epaper_canvas *canvas, gd_epaper_display_dev *display);
+    /*!
+     * @brief Function to draw single pixel
+     */
+    void gd_epaper_draw_pixel(gd_epaper_canvas *canvas, int16_t x, int16_t y, gd_epaper_color color);
+    /*!
+     * @brief Function to fill rectangle
+     */
+    void gd_epaper_fill_rect(gd_epaper_canvas *canvas, const gd_epaper_region *rect, gd_epaper_color color);
+    /*!
+     * @brief Function to draw line
+     */
+    void gd_epaper_draw_line(gd_epaper_canvas *canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, gd_epaper_color color);
+    /*!
+     * @brief Function to draw 1bpp bitmap, set bits are drawn with color, others are transparent
+     */
+    void gd_epaper_draw_bitmap(gd_epaper_canvas *canvas, int16_t x, int16_t y, uint16_t width, uint16_t height,
+                               const uint8_t *bitmap, gd_epaper_color color);
+    /*!
+     * @brief Function to draw single line text, characters missing in font are skipped
+     */
+    void gd_epaper_draw_text(gd_epaper_canvas *canvas, int16_t x, int16_t y, const gd_epaper_font *font,
+                             const char *text, gd_epaper_color color);
+
+    /*!
+     * @brief Built-in text field render function, draws text with font
+     */
+    void gd_epaper_widget_render_text(const gd_epaper_widget *widget, gd_epaper_canvas *canvas);
+    /*!
+     * @brief Built-in number render function, draws value with font
+     */
+    void gd_epaper_widget_render_number(const gd_epaper_widget *widget, gd_epaper_canvas *canvas);
+    /*!
+     * @brief Built-in gauge render function, draws framed bar filled proportionally to value in min..max
+     */
+    void gd_epaper_widget_render_gauge(const gd_epaper_widget *widget, gd_epaper_canvas *canvas);
+    /*!
+     * @brief Built-in icon render function, draws bitmap of bounds size
+     */
+    void gd_epaper_widget_render_icon(const gd_epaper_widget *widget, gd_epaper_canvas *canvas);
+    /*!
+     * @brief Built-in bar chart render function, draws series as bars scaled to min..max
+     */
+    void gd_epaper_widget_render_bar_chart(const gd_epaper_widget *widget, gd_epaper_canvas *canvas);
+    /*!
+     * @brief Built-in sparkline render function, draws series as polyline scaled to min..max
+     */
+    void gd_epaper_widget_render_sparkline(const gd_epaper_widget *widget, gd_epaper_canvas *canvas);
+
+    /*!
+     * @brief Function to init widget tree, whole tree is invalidated
+     *
+     * @param[out] screen          : Widget screen pointer
+     * @param[in] display          : Display device pointer
+     * @param[in] root             : First top level widget, may be NULL
+     */
+    void gd_epaper_widget_screen_init(gd_epaper_widget_screen *screen, gd_epaper_display_dev *display, gd_epaper_widget *root);
+    /*!
+     * @brief Function to append widget to parent children, or to top level widgets if parent is NULL. Widget is invalidated
+     *
+     * @param[in] screen           : Widget screen pointer
+     * @param[in] parent           : Parent widget or NULL
+     * @param[in] widget           : Widget to add
+     */
+    void gd_epaper_widget_add(gd_epaper_widget_screen *screen, gd_epaper_widget *parent, gd_epaper_widget *widget);
+    /*!
+     * @brief Function to mark widget for re-render, its bounds are merged with overlapping or close dirty region,
+     * or added as new one
+     *
+     * @param[in] screen           : Widget screen pointer
+     * @param[in] widget           : Changed widget
+     */
+    void gd_epaper_widget_invalidate(gd_epaper_widget_screen *screen, gd_epaper_widget *widget);
+    /*!
+     * @brief Function to set widget value, widget is invalidated only if value changed
+     */
+    void gd_epaper_widget_set_value(gd_epaper_widget_screen *screen, gd_epaper_widget *widget, int32_t value);
+    /*!
+     * @brief Function to set widget text, widget is invalidated only if text changed.
+     * Same pointer always invalidates widget, as buffer content may be changed in place
+     */
+    void gd_epaper_widget_set_text(gd_epaper_widget_screen *screen, gd_epaper_widget *widget, const char *text);
+    /*!
+     * @brief Function to set widget series, widget is always invalidated as series may be changed in place
+     */
+    void gd_epaper_widget_set_series(gd_epaper_widget_screen *screen, gd_epaper_widget *widget, const int32_t *series, size_t count);
+    /*!
+     * @brief Function to render invalidated widgets to screen buffer. Widgets overlapping every dirty region
+     * are drawn clipped to it, so other pixels are not touched
+     *
+     * @param[in] screen           : Widget screen pointer
+     * @param[out] regions         : Rendered regions, GD_EPAPER_WIDGET_MAX_DIRTY entries, may be NULL
+     *
+     * @retval Rendered regions count
+     */
+    uint8_t gd_epaper_widget_render(gd_epaper_widget_screen *screen, gd_epaper_region *regions);
+    /*!
+     * @brief Function to render invalidated widgets and partially refresh display once with union of rendered regions
+     *
+     * @param[in] screen           : Widget screen pointer
+     *
+     * @retval GD_EPAPER_OK              -> Success, or nothing to update.
+     * @retval Other error               -> See gd_epaper_update_region.
+     */
+    int8_t gd_epaper_widget_update(gd_epaper_widget_screen *screen);
+
+#ifdef __cplusplus
+}
+#endif
+#endif